@@ -0,0 +1,209 @@
+/**
+ * @file BoundedObjectAllocator.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements BoundedObjectAllocator, a thread-safe ObjectAllocator that waits for
+ * a free block when it is exhausted.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "BoundedObjectAllocator.h"
+
+/**
+ * @brief Construct a new BoundedObjectAllocator
+ *
+ * @param ObjectSize size of each object
+ * @param config configuration of the pool, MaxPages_ bounds it
+ */
+BoundedObjectAllocator::BoundedObjectAllocator(size_t ObjectSize, const OAConfig &config)
+    : allocator_{ObjectSize, config}, waitingThreads_{0}
+#if OA_HAS_COROUTINES
+      , awaitersHead_{nullptr}, awaitersTail_{nullptr}
+#endif
+{
+}
+
+/**
+ * @brief Allocates a block if the pool isn't exhausted
+ *
+ * @param label Label passed to ObjectAllocator::Allocate
+ * @return void* The block, null if MaxPages_ is reached and nothing is free
+ * @exception OAException Any other failure of ObjectAllocator::Allocate
+ */
+void *BoundedObjectAllocator::TryAllocateLocked(const char *label)
+{
+    try
+    {
+        return allocator_.Allocate(label);
+    }
+    catch (OAException &e)
+    {
+        if (e.code() != OAException::E_NO_PAGES)
+            throw;
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Allocates a block, never waits
+ *
+ * @param label Label passed to ObjectAllocator::Allocate
+ * @return void* The block, null if the pool is exhausted
+ */
+void *BoundedObjectAllocator::TryAllocate(const char *label)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return TryAllocateLocked(label);
+}
+
+/**
+ * @brief Allocates a block, waiting for one to be freed if the pool is exhausted
+ *
+ * @param label Label passed to ObjectAllocator::Allocate
+ * @return void* The block
+ */
+void *BoundedObjectAllocator::Allocate(const char *label)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    void *block = TryAllocateLocked(label);
+    if (block)
+        return block;
+
+    ++waitingThreads_;
+    while (!(block = TryAllocateLocked(label)))
+        freed_.wait(lock);
+    --waitingThreads_;
+    return block;
+}
+
+/**
+ * @brief Allocates a block, waiting at most timeout for one to be freed
+ *
+ * @param timeout Longest wait
+ * @param label Label passed to ObjectAllocator::Allocate
+ * @return void* The block, null on timeout
+ */
+void *BoundedObjectAllocator::AllocateFor(std::chrono::nanoseconds timeout, const char *label)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+    void *block = TryAllocateLocked(label);
+    if (block)
+        return block;
+
+    ++waitingThreads_;
+    while (!(block = TryAllocateLocked(label)))
+    {
+        if (freed_.wait_until(lock, deadline) == std::cv_status::timeout)
+        {
+            block = TryAllocateLocked(label); //a block may have been freed right at the deadline
+            break;
+        }
+    }
+    --waitingThreads_;
+    return block;
+}
+
+/**
+ * @brief Returns a block to the pool and wakes one waiter. Suspended coroutines are served first,
+ *  in the order they suspended, and are resumed on this thread after the lock is released.
+ *
+ * @param Object Block to free
+ * @exception OAException Anything ObjectAllocator::Free throws
+ */
+void BoundedObjectAllocator::Free(void *Object)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    allocator_.Free(Object);
+
+#if OA_HAS_COROUTINES
+    if (awaitersHead_)
+    {
+        AllocateAwaiter *awaiter = awaitersHead_;
+        awaiter->block_ = TryAllocateLocked(awaiter->label_); //gets the block just freed
+        if (awaiter->block_)
+        {
+            awaitersHead_ = awaiter->next_;
+            if (!awaitersHead_)
+                awaitersTail_ = nullptr;
+            lock.unlock();
+            awaiter->handle_.resume();
+            return;
+        }
+    }
+#endif
+
+    bool wake = waitingThreads_ != 0;
+    lock.unlock();
+    if (wake)
+        freed_.notify_one();
+}
+
+/**
+ * @brief Returns the statistics of the underlying allocator
+ *
+ * @return OAStats The statistics
+ */
+OAStats BoundedObjectAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocator_.GetStats();
+}
+
+/**
+ * @brief Number of threads and coroutines waiting for a block
+ *
+ * @return unsigned Count
+ */
+unsigned BoundedObjectAllocator::Waiting() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    unsigned count = waitingThreads_;
+#if OA_HAS_COROUTINES
+    for (AllocateAwaiter *awaiter = awaitersHead_; awaiter; awaiter = awaiter->next_)
+        ++count;
+#endif
+    return count;
+}
+
+#if OA_HAS_COROUTINES
+/**
+ * @brief Takes a block without suspending if one is free
+ *
+ * @return true A block was allocated, the coroutine continues
+ * @return false The coroutine must suspend
+ */
+bool BoundedObjectAllocator::AllocateAwaiter::await_ready()
+{
+    block_ = pool_.TryAllocate(label_);
+    return block_ != nullptr;
+}
+
+/**
+ * @brief Queues the coroutine until Free hands it a block. Tries once more under the lock so a
+ *  Free that happened after await_ready isn't missed.
+ *
+ * @param handle The suspending coroutine
+ * @return true Suspended
+ * @return false A block got free, the coroutine continues
+ */
+bool BoundedObjectAllocator::AllocateAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> lock(pool_.mutex_);
+    block_ = pool_.TryAllocateLocked(label_);
+    if (block_)
+        return false;
+    handle_ = handle;
+    next_ = nullptr;
+    if (pool_.awaitersTail_)
+        pool_.awaitersTail_->next_ = this;
+    else
+        pool_.awaitersHead_ = this;
+    pool_.awaitersTail_ = this;
+    return true;
+}
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file BoundedObjectAllocator.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of BoundedObjectAllocator, a thread-safe ObjectAllocator
+ * whose Allocate waits for a block to be freed when MaxPages_ is reached, instead of throwing E_NO_PAGES.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef BOUNDEDOBJECTALLOCATORH
+#define BOUNDEDOBJECTALLOCATORH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define OA_HAS_COROUTINES 1
+#else
+#define OA_HAS_COROUTINES 0
+#endif
+
+/*!
+  Bounded pool for producer pipelines: when the pool is exhausted, Allocate blocks (or a coroutine
+  suspends) until another thread frees a block, which gives backpressure without busy retries.
+*/
+class BoundedObjectAllocator
+{
+  public:
+      // Creates the pool, config.MaxPages_ is the bound (0=unbounded, Allocate never waits)
+    BoundedObjectAllocator(size_t ObjectSize, const OAConfig &config);
+
+      // Waits as long as it takes for a block
+    void *Allocate(const char *label = 0);
+
+      // Waits at most timeout for a block, returns null on timeout
+    void *AllocateFor(std::chrono::nanoseconds timeout, const char *label = 0);
+
+      // Never waits, returns null if the pool is exhausted
+    void *TryAllocate(const char *label = 0);
+
+      // Returns a block and wakes one waiter (a suspended coroutine is handed the block directly)
+    void Free(void *Object);
+
+    OAStats GetStats() const;   // returns the statistics of the underlying allocator
+    unsigned Waiting() const;   // number of threads and coroutines waiting for a block
+
+#if OA_HAS_COROUTINES
+    /*!
+      Awaitable returned by AllocateAsync, co_await gives the block
+    */
+    class AllocateAwaiter
+    {
+      public:
+        AllocateAwaiter(BoundedObjectAllocator &pool, const char *label)
+            : pool_(pool), label_(label), block_(nullptr), next_(nullptr) {}
+        bool await_ready();                              // true if a block was free right away
+        bool await_suspend(std::coroutine_handle<> handle); // queues the coroutine unless a block got free
+        void *await_resume() { return block_; }
+
+      private:
+        friend class BoundedObjectAllocator;
+        BoundedObjectAllocator &pool_;   //!< pool to allocate from
+        const char *label_;              //!< label passed to Allocate
+        void *block_;                    //!< the block, once allocated
+        AllocateAwaiter *next_;          //!< next coroutine in the waiting queue
+        std::coroutine_handle<> handle_; //!< coroutine to resume with the block
+    };
+
+      // co_await AllocateAsync() suspends the coroutine until a block is free
+    AllocateAwaiter AllocateAsync(const char *label = 0) { return AllocateAwaiter(*this, label); }
+#endif
+
+      // Prevent copy construction and assignment
+    BoundedObjectAllocator(const BoundedObjectAllocator &) = delete;            //!< Do not implement!
+    BoundedObjectAllocator &operator=(const BoundedObjectAllocator &) = delete; //!< Do not implement!
+
+  private:
+    mutable std::mutex mutex_;          // guards everything below
+    std::condition_variable freed_;     // signalled by Free for blocked threads
+    ObjectAllocator allocator_;         // the single-threaded pool
+    unsigned waitingThreads_;           // threads blocked in Allocate/AllocateFor
+#if OA_HAS_COROUTINES
+    AllocateAwaiter *awaitersHead_;     // FIFO of suspended coroutines
+    AllocateAwaiter *awaitersTail_;
+#endif
+
+    void *TryAllocateLocked(const char *label); // mutex_ must be held
+};
+
+#endif
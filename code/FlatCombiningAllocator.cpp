@@ -0,0 +1,251 @@
+/**
+ * @file FlatCombiningAllocator.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements FlatCombiningAllocator, the flat-combining front end of ObjectAllocator.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "FlatCombiningAllocator.h"
+#include <algorithm>
+#include <new>
+#include <thread>
+
+const unsigned FlatCombiningAllocator::DEFAULT_SLOTS;
+const size_t FlatCombiningAllocator::CACHE_LINE;
+
+static std::atomic<unsigned long long> nextId{1}; // ids of the allocators, never reused
+static const unsigned SPINS_BEFORE_YIELD = 64;    // polls of a slot before the waiter yields its core
+
+/**
+ * @brief Construct a new FlatCombiningAllocator
+ *
+ * @param ObjectSize size of each object
+ * @param config configuration of the pool
+ * @param Slots most threads that publish requests, the others call the allocator under the lock
+ */
+FlatCombiningAllocator::FlatCombiningAllocator(size_t ObjectSize, const OAConfig &config, unsigned Slots)
+    : allocator_{ObjectSize, config}, table_{std::make_shared<SlotTable>(Slots)}, id_{nextId++}, batches_{0}, requests_{0}
+{
+    for (Slot &slot : table_->slots_)
+    {
+        slot.op_.store(opNone, std::memory_order_relaxed);
+        slot.owned_.store(false, std::memory_order_relaxed);
+        slot.label_ = nullptr;
+        slot.object_ = nullptr;
+    }
+}
+
+/*!
+  The slots a thread holds, one per allocator it used. The destructor runs when the thread exits and
+  gives them back; the tables are reached through weak pointers, so allocators destroyed first are
+  skipped, and their entries are dropped whenever the thread takes a new slot.
+*/
+struct FlatCombiningAllocator::ThreadSlots
+{
+    /*!
+      A slot of one allocator
+    */
+    struct Entry
+    {
+        unsigned long long id_;          //!< the allocator
+        std::weak_ptr<SlotTable> table_; //!< its slots
+        unsigned index_;                 //!< the one held
+    };
+
+    ~ThreadSlots() // the thread is exiting
+    {
+        for (const Entry &entry : entries_)
+            if (std::shared_ptr<SlotTable> table = entry.table_.lock())
+                Release(*table, entry.index_);
+    }
+
+    static void Release(SlotTable &table, unsigned index) // lets another thread take the slot
+    {
+        table.slots_[index].owned_.store(false, std::memory_order_release);
+        table.free_.fetch_add(1, std::memory_order_release);
+    }
+
+    std::vector<Entry> entries_; //!< the slots held
+};
+
+/**
+ * @brief The slot of the calling thread. A thread keeps its slot until it exits, the slot index is
+ *  cached per thread. A thread without one takes the first free slot.
+ *
+ * @return Slot* The slot, null if every slot is held by another thread
+ */
+FlatCombiningAllocator::Slot *FlatCombiningAllocator::ThreadSlot()
+{
+    static thread_local ThreadSlots held;
+    for (const ThreadSlots::Entry &entry : held.entries_)
+        if (entry.id_ == id_)
+            return &table_->slots_[entry.index_];
+
+    SlotTable &table = *table_;
+    if (table.free_.load(std::memory_order_acquire) == 0)
+        return nullptr;
+    for (unsigned index = 0; index < table.slots_.size(); ++index)
+    {
+        Slot &slot = table.slots_[index];
+        bool owned = false;
+        if (slot.owned_.load(std::memory_order_relaxed) || !slot.owned_.compare_exchange_strong(owned, true, std::memory_order_acquire))
+            continue;
+        table.free_.fetch_sub(1, std::memory_order_relaxed);
+        try
+        {
+            held.entries_.erase(std::remove_if(held.entries_.begin(), held.entries_.end(),
+                                               [](const ThreadSlots::Entry &entry) { return entry.table_.expired(); }),
+                                held.entries_.end()); //allocators destroyed since
+            held.entries_.push_back(ThreadSlots::Entry{id_, table_, index});
+        }
+        catch (std::bad_alloc &)
+        {
+            ThreadSlots::Release(table, index); //can't remember it, use the lock this time
+            return nullptr;
+        }
+        unsigned claimed = table.claimed_.load(std::memory_order_relaxed);
+        while (claimed <= index && !table.claimed_.compare_exchange_weak(claimed, index + 1, std::memory_order_relaxed))
+        {
+        }
+        return &slot;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Publishes a request, then combines if the lock is free or waits until a combiner served it
+ *
+ * @param op opAllocate or opFree
+ * @param label Argument of Allocate
+ * @param object Argument of Free
+ * @return void* Result of Allocate
+ * @exception OAException What the allocator threw for this request
+ */
+void *FlatCombiningAllocator::Submit(int op, const char *label, void *object)
+{
+    Slot *slot = ThreadSlot();
+    if (!slot) //no slot left, plain locking
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (op == opAllocate)
+            return allocator_.Allocate(label);
+        allocator_.Free(object);
+        return nullptr;
+    }
+
+    slot->label_ = label;
+    slot->object_ = object;
+    slot->op_.store(op, std::memory_order_release);
+    for (unsigned spins = 0; slot->op_.load(std::memory_order_acquire) != opNone; ++spins)
+    {
+        std::unique_lock<std::mutex> combiner(lock_, std::try_to_lock);
+        if (combiner.owns_lock())
+            Combine(); //serves our request too
+        else if (spins >= SPINS_BEFORE_YIELD)
+            std::this_thread::yield();
+    }
+
+    if (slot->error_)
+    {
+        std::exception_ptr error = nullptr;
+        error.swap(slot->error_);
+        std::rethrow_exception(error);
+    }
+    return slot->object_;
+}
+
+/**
+ * @brief Serves every published request against the allocator, in slot order
+ *
+ */
+void FlatCombiningAllocator::Combine()
+{
+    unsigned claimed = table_->claimed_.load(std::memory_order_relaxed);
+    unsigned served = 0;
+    for (unsigned i = 0; i < claimed; ++i)
+    {
+        Slot &slot = table_->slots_[i];
+        int op = slot.op_.load(std::memory_order_acquire);
+        if (op == opNone)
+            continue;
+        try
+        {
+            if (op == opAllocate)
+                slot.object_ = allocator_.Allocate(slot.label_);
+            else
+                allocator_.Free(slot.object_);
+        }
+        catch (...) //handed to the owner, so the other requests are still served
+        {
+            slot.error_ = std::current_exception();
+        }
+        ++served;
+        slot.op_.store(opNone, std::memory_order_release);
+    }
+    if (served)
+    {
+        ++batches_;
+        requests_ += served;
+    }
+}
+
+/**
+ * @brief Allocates a block through the combiner
+ *
+ * @param label Label passed to ObjectAllocator::Allocate
+ * @return void* The block
+ * @exception OAException Anything ObjectAllocator::Allocate throws
+ */
+void *FlatCombiningAllocator::Allocate(const char *label)
+{
+    return Submit(opAllocate, label, nullptr);
+}
+
+/**
+ * @brief Frees a block through the combiner
+ *
+ * @param Object Block to free
+ * @exception OAException Anything ObjectAllocator::Free throws
+ */
+void FlatCombiningAllocator::Free(void *Object)
+{
+    Submit(opFree, nullptr, Object);
+}
+
+/**
+ * @brief Returns the statistics of the underlying allocator
+ *
+ * @return OAStats The statistics
+ */
+OAStats FlatCombiningAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return allocator_.GetStats();
+}
+
+/**
+ * @brief Number of batches served, Requests() / Batches() is the average batch
+ *
+ * @return unsigned long long Count
+ */
+unsigned long long FlatCombiningAllocator::Batches() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return batches_;
+}
+
+/**
+ * @brief Number of requests served by combining
+ *
+ * @return unsigned long long Count
+ */
+unsigned long long FlatCombiningAllocator::Requests() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return requests_;
+}
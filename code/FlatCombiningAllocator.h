@@ -0,0 +1,107 @@
+/**
+ * @file FlatCombiningAllocator.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of FlatCombiningAllocator, a thread-safe front end of
+ * ObjectAllocator where one thread at a time serves the requests of all the others in a batch.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef FLATCOMBININGALLOCATORH
+#define FLATCOMBININGALLOCATORH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*!
+  Flat combining: a thread publishes its Allocate or Free in its own slot, then either takes the
+  combiner lock and serves every published request, or waits for the combiner to serve it. The
+  single-threaded ObjectAllocator is only touched by the combiner, so its free list and counters stay
+  in one core's cache, and the lock changes hands once per batch instead of once per request.
+  A thread holds a slot from its first request until it exits; threads beyond the number of slots
+  lock and call the allocator directly until a slot is given back.
+*/
+class FlatCombiningAllocator
+{
+  public:
+    static const unsigned DEFAULT_SLOTS = 64;   //!< threads served by combining
+    static const size_t CACHE_LINE = 64;        //!< slots are this far apart
+
+      // Creates the pool, Slots is the most threads that publish requests at the same time
+    FlatCombiningAllocator(size_t ObjectSize, const OAConfig &config, unsigned Slots = DEFAULT_SLOTS);
+
+      // Same as ObjectAllocator::Allocate, served by the combiner
+    void *Allocate(const char *label = 0);
+
+      // Same as ObjectAllocator::Free, served by the combiner
+    void Free(void *Object);
+
+    OAStats GetStats() const;                 // returns the statistics of the underlying allocator
+    unsigned long long Batches() const;       // batches served so far
+    unsigned long long Requests() const;      // requests served by combining so far
+
+      // Prevent copy construction and assignment
+    FlatCombiningAllocator(const FlatCombiningAllocator &) = delete;            //!< Do not implement!
+    FlatCombiningAllocator &operator=(const FlatCombiningAllocator &) = delete; //!< Do not implement!
+
+  private:
+    /*!
+      Kind of request in a slot
+    */
+    enum OPERATION
+    {
+      opNone,     //!< nothing pending, or served
+      opAllocate, //!< Allocate(label_)
+      opFree      //!< Free(object_)
+    };
+
+    /*!
+      Request of one thread, on its own cache line
+    */
+    struct alignas(CACHE_LINE) Slot
+    {
+      std::atomic<int> op_;              //!< OPERATION, set by the owner, cleared by the combiner
+      std::atomic<bool> owned_;          //!< held by a live thread
+      const char *label_;                //!< argument of Allocate
+      void *object_;                     //!< argument of Free, result of Allocate
+      std::exception_ptr error_;         //!< what the request threw, rethrown by the owner (null if it didn't)
+    };
+
+    /*!
+      The slots, shared with the threads holding one so they can give it back when they exit, even
+      if that is after the allocator is gone
+    */
+    struct SlotTable
+    {
+      explicit SlotTable(unsigned count) : slots_(count), claimed_(0), free_(count) {}
+
+      std::vector<Slot> slots_;        //!< one per thread
+      std::atomic<unsigned> claimed_;  //!< highest slot ever held + 1, the combiner looks no further
+      std::atomic<unsigned> free_;     //!< slots not held, threads without one look for one while it isn't 0
+    };
+
+    struct ThreadSlots;                    // the slots held by a thread (thread_local)
+
+    mutable std::mutex lock_;              // the combiner lock, held while the allocator is used
+    ObjectAllocator allocator_;            // the single-threaded pool
+    std::shared_ptr<SlotTable> table_;     // the slots
+    unsigned long long id_;                // tells allocators apart in the threads' slot caches
+    unsigned long long batches_;           // counters (lock_)
+    unsigned long long requests_;
+
+    Slot *ThreadSlot();                    // slot of the calling thread, null if none is free
+    void *Submit(int op, const char *label, void *object); // publishes a request and waits for it
+    void Combine();                        // serves every published request (lock_ held)
+};
+
+#endif
@@ -0,0 +1,386 @@
+/**
+ * @file ForkFriendlyAllocator.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements ForkFriendlyAllocator, the pool that keeps its metadata out of its
+ * object pages, and the pthread_atfork handlers shared by all such pools.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "ForkFriendlyAllocator.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define OA_HAS_ATFORK 1
+#else
+#define OA_HAS_ATFORK 0
+#endif
+
+const size_t ForkFriendlyAllocator::OS_PAGE_SIZE;
+
+static std::mutex registryMutex;                      // guards registry, held across fork
+static std::vector<ForkFriendlyAllocator *> *registry; // every live pool (never freed, children use it)
+static std::once_flag atforkOnce;                     // pthread_atfork is registered once
+
+/**
+ * @brief Construct a new ForkFriendlyAllocator
+ *
+ * @param ObjectSize size of each object
+ * @param config configuration, see the class comment for the fields used
+ * @exception OAException E_NO_MEMORY No memory
+ * @exception OAException E_NO_PAGES MaxPages_ doesn't allow the first page
+ */
+ForkFriendlyAllocator::ForkFriendlyAllocator(size_t ObjectSize, const OAConfig &config)
+    : configuration{config}, current_{nullptr}
+{
+    size_t alignment = config.Alignment_ ? config.Alignment_ : sizeof(void *);
+    stride_ = (ObjectSize + alignment - 1) / alignment * alignment;
+    size_t pageBytes = config.PageBytes_ ? config.PageBytes_ : stride_ * (config.ObjectsPerPage_ ? config.ObjectsPerPage_ : 1);
+    pageBytes = (pageBytes + OS_PAGE_SIZE - 1) / OS_PAGE_SIZE * OS_PAGE_SIZE; //whole OS pages, the tail holds more objects
+    objects_ = static_cast<unsigned>(pageBytes / stride_);
+    if (!objects_)
+        throw OAException(OAException::E_NO_MEMORY, "PageBytes_ is too small for a single object!");
+    configuration.ObjectsPerPage_ = objects_;
+    configuration.PadBytes_ = 0;
+    stats.ObjectSize_ = ObjectSize;
+    stats.PageSize_ = pageBytes;
+
+    NewPage();
+
+    std::call_once(atforkOnce, [] {
+        registry = new std::vector<ForkFriendlyAllocator *>;
+#if OA_HAS_ATFORK
+        pthread_atfork(ForkPrepare, ForkParent, ForkChild);
+#endif
+    });
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry->push_back(this);
+}
+
+/**
+ * @brief Destroy the ForkFriendlyAllocator, frees every page
+ *
+ */
+ForkFriendlyAllocator::~ForkFriendlyAllocator()
+{
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry->erase(std::remove(registry->begin(), registry->end(), this), registry->end());
+    }
+    for (PageMeta *meta : pages_)
+        DeletePage(meta);
+}
+
+/**
+ * @brief Adds a page. Its memory is never written by the allocator.
+ *
+ * @exception OAException E_NO_PAGES MaxPages_ reached
+ * @exception OAException E_NO_MEMORY No memory
+ */
+void ForkFriendlyAllocator::NewPage()
+{
+    if (configuration.MaxPages_ && stats.PagesInUse_ >= configuration.MaxPages_)
+        throw OAException(OAException::E_NO_PAGES, "Exceeded max pages!");
+
+    PageMeta *meta = nullptr;
+    try
+    {
+        meta = new PageMeta();
+        size_t bitmapBytes = (objects_ + 7) / 8;
+        meta->freeStack_ = new unsigned[objects_];
+        meta->inUse_ = new unsigned char[bitmapBytes]();
+        if (configuration.HBlockInfo_.type_ != OAConfig::hbNone)
+            meta->allocNums_ = new unsigned[objects_]();
+        meta->base_ = static_cast<unsigned char *>(::operator new(stats.PageSize_, std::align_val_t(OS_PAGE_SIZE)));
+        pages_.insert(std::upper_bound(pages_.begin(), pages_.end(), meta,
+                                       [](const PageMeta *a, const PageMeta *b) { return a->base_ < b->base_; }),
+                      meta);
+    }
+    catch (std::bad_alloc &)
+    {
+        if (meta)
+        {
+            if (meta->base_)
+                ::operator delete(meta->base_, std::align_val_t(OS_PAGE_SIZE));
+            delete[] meta->freeStack_;
+            delete[] meta->inUse_;
+            delete[] meta->allocNums_;
+            delete meta;
+        }
+        throw OAException(OAException::E_NO_MEMORY, "Out of memory!");
+    }
+
+    for (unsigned i = 0; i < objects_; ++i) //lowest address on top
+        meta->freeStack_[i] = objects_ - 1 - i;
+    meta->free_ = objects_;
+    if (current_ && current_->free_)
+    {
+        current_->partial_ = true;
+        partial_.push_back(current_);
+    }
+    current_ = meta;
+    ++stats.PagesInUse_;
+    stats.FreeObjects_ += objects_;
+}
+
+/**
+ * @brief Returns the memory of a page and its metadata
+ *
+ * @param meta Page to delete, already removed from pages_ and partial_ (or the pool is being destroyed)
+ */
+void ForkFriendlyAllocator::DeletePage(PageMeta *meta)
+{
+    ::operator delete(meta->base_, std::align_val_t(OS_PAGE_SIZE));
+    delete[] meta->freeStack_;
+    delete[] meta->inUse_;
+    delete[] meta->allocNums_;
+    delete meta;
+}
+
+/**
+ * @brief Allocates an object. Only the metadata of its page is written.
+ *
+ * @param label Ignored, labels need tags in the object pages
+ * @return void* The object
+ * @exception OAException E_NO_PAGES MaxPages_ reached
+ * @exception OAException E_NO_MEMORY No memory
+ */
+void *ForkFriendlyAllocator::Allocate(const char *label)
+{
+    (void)label;
+    if (!current_->free_)
+    {
+        if (partial_.empty())
+            NewPage();
+        else
+        {
+            current_ = partial_.back();
+            partial_.pop_back();
+            current_->partial_ = false;
+        }
+    }
+
+    unsigned index = current_->freeStack_[--current_->free_];
+    current_->inUse_[index / 8] |= static_cast<unsigned char>(1u << (index % 8));
+    ++stats.Allocations_;
+    if (current_->allocNums_)
+        current_->allocNums_[index] = stats.Allocations_;
+    ++stats.ObjectsInUse_;
+    --stats.FreeObjects_;
+    if (stats.ObjectsInUse_ > stats.MostObjects_)
+        stats.MostObjects_ = stats.ObjectsInUse_;
+    return current_->base_ + index * stride_;
+}
+
+/**
+ * @brief Returns an object to its page's free stack
+ *
+ * @param Object Object to free
+ * @exception OAException E_BAD_BOUNDARY Not an object of this pool
+ * @exception OAException E_MULTIPLE_FREE Already free
+ */
+void ForkFriendlyAllocator::Free(void *Object)
+{
+    PageMeta *meta = FindPage(Object);
+    if (!meta)
+        throw OAException(OAException::E_BAD_BOUNDARY, "OUT OF PAGE BOUNDARY");
+    unsigned index = BlockIndex(meta, Object);
+    unsigned char bit = static_cast<unsigned char>(1u << (index % 8));
+    if (!(meta->inUse_[index / 8] & bit))
+        throw OAException(OAException::E_MULTIPLE_FREE, "Multiple free!");
+
+    meta->inUse_[index / 8] &= static_cast<unsigned char>(~bit);
+    if (meta->allocNums_)
+        meta->allocNums_[index] = 0;
+    meta->freeStack_[meta->free_++] = index;
+    if (meta != current_ && !meta->partial_)
+    {
+        meta->partial_ = true;
+        partial_.push_back(meta);
+    }
+    ++stats.Deallocations_;
+    --stats.ObjectsInUse_;
+    ++stats.FreeObjects_;
+}
+
+/**
+ * @brief Finds the page holding an object
+ *
+ * @param Object Address to look up
+ * @return PageMeta* The page, null if the address isn't in the pool
+ */
+ForkFriendlyAllocator::PageMeta *ForkFriendlyAllocator::FindPage(const void *Object) const
+{
+    const unsigned char *address = static_cast<const unsigned char *>(Object);
+    std::vector<PageMeta *>::const_iterator it = std::upper_bound(pages_.begin(), pages_.end(), address,
+        [](const unsigned char *a, const PageMeta *meta) { return a < meta->base_; });
+    if (it == pages_.begin())
+        return nullptr;
+    PageMeta *meta = *(it - 1);
+    return address < meta->base_ + stats.PageSize_ ? meta : nullptr;
+}
+
+/**
+ * @brief Index of a block on its page
+ *
+ * @param meta Page of the block
+ * @param Object The block
+ * @return unsigned Index
+ * @exception OAException E_BAD_BOUNDARY Not at the start of a block
+ */
+unsigned ForkFriendlyAllocator::BlockIndex(const PageMeta *meta, const void *Object) const
+{
+    size_t offset = static_cast<size_t>(static_cast<const unsigned char *>(Object) - meta->base_);
+    if (offset % stride_ || offset / stride_ >= objects_)
+        throw OAException(OAException::E_BAD_BOUNDARY, "BAD BOUNDARY");
+    return static_cast<unsigned>(offset / stride_);
+}
+
+/**
+ * @brief Calls the callback fn for each block in use
+ *
+ * @param fn Callback fn
+ * @return unsigned Number of blocks in use
+ */
+unsigned ForkFriendlyAllocator::DumpMemoryInUse(ObjectAllocator::DUMPCALLBACK fn) const
+{
+    unsigned count = 0;
+    for (const PageMeta *meta : pages_)
+        for (unsigned i = 0; i < objects_; ++i)
+            if (meta->inUse_[i / 8] & (1u << (i % 8)))
+            {
+                ++count;
+                fn(meta->base_ + i * stride_, stats.ObjectSize_);
+            }
+    return count;
+}
+
+/**
+ * @brief Frees all empty pages except the current one
+ *
+ * @return unsigned Number of pages freed
+ */
+unsigned ForkFriendlyAllocator::FreeEmptyPages()
+{
+    unsigned freed = 0;
+    std::vector<PageMeta *>::iterator keep = pages_.begin();
+    for (PageMeta *meta : pages_)
+    {
+        if (meta->free_ == objects_ && meta != current_)
+        {
+            partial_.erase(std::find(partial_.begin(), partial_.end(), meta));
+            DeletePage(meta);
+            ++freed;
+        }
+        else
+            *keep++ = meta;
+    }
+    pages_.erase(keep, pages_.end());
+    stats.PagesInUse_ -= freed;
+    stats.FreeObjects_ -= freed * objects_;
+    return freed;
+}
+
+/**
+ * @brief Allocation number of a live block
+ *
+ * @param Object The block
+ * @return unsigned Its allocation number, 0 if it is free or the pool keeps no headers
+ */
+unsigned ForkFriendlyAllocator::AllocationNumber(const void *Object) const
+{
+    const PageMeta *meta = FindPage(Object);
+    if (!meta || !meta->allocNums_)
+        return 0;
+    return meta->allocNums_[BlockIndex(meta, Object)];
+}
+
+/**
+ * @brief Get the configuration, ObjectsPerPage_ is the number that fit the OS pages
+ *
+ * @return OAConfig The configuration
+ */
+OAConfig ForkFriendlyAllocator::GetConfig() const
+{
+    return configuration;
+}
+
+/**
+ * @brief Get the statistics
+ *
+ * @return OAStats The statistics
+ */
+OAStats ForkFriendlyAllocator::GetStats() const
+{
+    return stats;
+}
+
+/**
+ * @brief Size of the metadata area, the most a forked child copies besides the pages it writes
+ *
+ * @return size_t Bytes
+ */
+size_t ForkFriendlyAllocator::MetadataBytes() const
+{
+    size_t perPage = sizeof(PageMeta) + objects_ * sizeof(unsigned) + (objects_ + 7) / 8;
+    if (configuration.HBlockInfo_.type_ != OAConfig::hbNone)
+        perPage += objects_ * sizeof(unsigned);
+    return perPage * pages_.size() + (pages_.capacity() + partial_.capacity()) * sizeof(PageMeta *);
+}
+
+/**
+ * @brief In the child, allocations continue on the page with the most free blocks and then go
+ *  down the partial list in that order, so the fewest inherited pages get copied
+ *
+ */
+void ForkFriendlyAllocator::OnForkChild()
+{
+    partial_.push_back(current_);
+    std::sort(partial_.begin(), partial_.end(), [](const PageMeta *a, const PageMeta *b) { return a->free_ < b->free_; });
+    current_ = partial_.back();
+    partial_.pop_back();
+    for (PageMeta *meta : partial_)
+        meta->partial_ = true;
+    current_->partial_ = false;
+    while (!partial_.empty() && !partial_.front()->free_) //the old current_ may have been full
+    {
+        partial_.front()->partial_ = false;
+        partial_.erase(partial_.begin());
+    }
+}
+
+/**
+ * @brief pthread_atfork prepare handler: no pool is created or destroyed while forking
+ *
+ */
+void ForkFriendlyAllocator::ForkPrepare()
+{
+    registryMutex.lock();
+}
+
+/**
+ * @brief pthread_atfork parent handler
+ *
+ */
+void ForkFriendlyAllocator::ForkParent()
+{
+    registryMutex.unlock();
+}
+
+/**
+ * @brief pthread_atfork child handler: reorders the pages of every pool
+ *
+ */
+void ForkFriendlyAllocator::ForkChild()
+{
+    for (ForkFriendlyAllocator *pool : *registry)
+        pool->OnForkChild();
+    registryMutex.unlock();
+}
@@ -0,0 +1,99 @@
+/**
+ * @file ForkFriendlyAllocator.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of ForkFriendlyAllocator, a pool whose pages hold nothing
+ * but client objects. The free lists and the header data live in a separate, compact metadata area,
+ * so a forked child that inherits a warm pool only copies the pages its own objects are written to.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef FORKFRIENDLYALLOCATORH
+#define FORKFRIENDLYALLOCATORH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <vector>
+
+/*!
+  Pool for pre-fork servers. Allocate and Free only write the metadata area, never the object pages,
+  and allocations fill one page before moving to the next, so after a fork the child touches as few
+  inherited pages as possible. A pthread_atfork handler makes the child start on the page with the
+  most free blocks.
+
+  Uses ObjectsPerPage_ or PageBytes_, Alignment_ and MaxPages_ of OAConfig. Any header type other
+  than hbNone keeps the allocation number of each block in the metadata area. PadBytes_, the other
+  header fields, labels and the debug patterns need writes to the object pages and are ignored, and
+  so is DebugOn_: Free always detects bad boundaries and double frees, from the metadata.
+*/
+class ForkFriendlyAllocator
+{
+  public:
+    static const size_t OS_PAGE_SIZE = 4096; //!< pages are aligned on and sized in OS pages
+
+      // Creates the pool and its first page
+    ForkFriendlyAllocator(size_t ObjectSize, const OAConfig &config);
+    ~ForkFriendlyAllocator();
+
+      // Take an object from the pool, filling the current page first
+    void *Allocate(const char *label = 0);
+
+      // Returns an object to the pool
+    void Free(void *Object);
+
+      // Calls the callback fn for each block still in use
+    unsigned DumpMemoryInUse(ObjectAllocator::DUMPCALLBACK fn) const;
+
+      // Frees all empty pages
+    unsigned FreeEmptyPages();
+
+      // Allocation number of a live block (0 if free or headers aren't kept)
+    unsigned AllocationNumber(const void *Object) const;
+
+    OAConfig GetConfig() const;   // returns the configuration parameters
+    OAStats GetStats() const;     // returns the statistics for the allocator
+    size_t MetadataBytes() const; // size of the metadata area, what a forked child may copy
+
+      // Prevent copy construction and assignment
+    ForkFriendlyAllocator(const ForkFriendlyAllocator &) = delete;            //!< Do not implement!
+    ForkFriendlyAllocator &operator=(const ForkFriendlyAllocator &) = delete; //!< Do not implement!
+
+  private:
+    /*!
+      Metadata of one page, allocated apart from the page
+    */
+    struct PageMeta
+    {
+      unsigned char *base_;     //!< first object of the page
+      unsigned *freeStack_;     //!< indices of the free blocks, the next one on top
+      unsigned char *inUse_;    //!< one bit per block
+      unsigned *allocNums_;     //!< allocation number of each block (null without headers)
+      unsigned free_;           //!< number of free blocks
+      bool partial_;            //!< on the partial list
+    };
+
+    OAConfig configuration;            // configuration parameters
+    OAStats stats;                     // statistical data
+    size_t stride_;                    // distance between objects
+    unsigned objects_;                 // objects per page
+    std::vector<PageMeta *> pages_;    // every page, sorted by address
+    std::vector<PageMeta *> partial_;  // pages with free blocks other than current_ (most free last after a fork)
+    PageMeta *current_;                // page allocations come from
+
+    void NewPage();                                 // adds a page, makes it current_
+    void DeletePage(PageMeta *meta);                // returns a page and its metadata
+    PageMeta *FindPage(const void *Object) const;   // page of an object, null if not in the pool
+    unsigned BlockIndex(const PageMeta *meta, const void *Object) const; // index of a block, checks the boundary
+    void OnForkChild();                             // the child starts on the page with the most free blocks
+
+    static void ForkPrepare(); // pthread_atfork handlers, for every pool
+    static void ForkParent();
+    static void ForkChild();
+};
+
+#endif
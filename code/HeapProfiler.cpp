@@ -0,0 +1,273 @@
+/**
+ * @file HeapProfiler.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements HeapProfiler, a sampling heap profiler for ObjectAllocator.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "HeapProfiler.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <cxxabi.h>
+#include <execinfo.h>
+#define HAS_BACKTRACE 1
+#else
+#define HAS_BACKTRACE 0
+#endif
+
+static const int SKIPPED_FRAMES = 2; // RecordAllocation and ObjectAllocator::Allocate
+
+/**
+ * @brief Construct a new HeapProfiler
+ *
+ * @param SampleBytes Mean number of bytes allocated between two samples (0 samples everything)
+ * @param MaxDepth Deepest stack trace recorded
+ */
+HeapProfiler::HeapProfiler(size_t SampleBytes, unsigned MaxDepth)
+    : sampleBytes_{SampleBytes}, maxDepth_{MaxDepth}, countdown_{0}, rng_{0}
+{
+    rng_ = static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count());
+    rng_ ^= reinterpret_cast<size_t>(this);
+    if (!rng_)
+        rng_ = 88172645463325252ull;
+    countdown_ = NextInterval();
+}
+
+/**
+ * @brief Draws the number of bytes until the next sample from an exponential distribution
+ *
+ * @return size_t Bytes until the next sample (at least 1)
+ */
+size_t HeapProfiler::NextInterval()
+{
+    if (sampleBytes_ == 0)
+        return 1; //sample every allocation
+
+    //xorshift64*
+    rng_ ^= rng_ >> 12;
+    rng_ ^= rng_ << 25;
+    rng_ ^= rng_ >> 27;
+    unsigned long long r = rng_ * 2685821657736338717ull;
+    double u = static_cast<double>((r >> 11) + 1) * (1.0 / 9007199254740992.0); //uniform in (0, 1]
+    double interval = -std::log(u) * static_cast<double>(sampleBytes_);
+    return interval < 1.0 ? 1 : static_cast<size_t>(interval);
+}
+
+/**
+ * @brief Inverse of the probability that a block of the given size is sampled
+ *
+ * @param bytes Size of the block
+ * @return double Number of bytes one sampled byte stands for
+ */
+double HeapProfiler::Scale(size_t bytes) const
+{
+    if (sampleBytes_ == 0 || bytes == 0)
+        return 1.0;
+    return 1.0 / (1.0 - std::exp(-static_cast<double>(bytes) / static_cast<double>(sampleBytes_)));
+}
+
+/**
+ * @brief Records the stack trace of a sampled allocation. Runs inside Allocate after the block is
+ *  taken, so it never throws: without memory for the trace or the tables the sample is dropped.
+ *
+ * @param Object Block given to the client
+ * @param bytes Size of the block
+ */
+void HeapProfiler::RecordAllocation(const void *Object, size_t bytes) noexcept
+{
+    try
+    {
+        Stack stack;
+#if HAS_BACKTRACE
+        std::vector<void *> frames(maxDepth_ + SKIPPED_FRAMES);
+        int depth = backtrace(frames.data(), static_cast<int>(frames.size()));
+        if (depth > SKIPPED_FRAMES)
+            stack.assign(frames.begin() + SKIPPED_FRAMES, frames.begin() + depth);
+#endif
+
+        Bucket &bucket = buckets_.emplace(stack, Bucket{0, 0, 0, 0}).first->second;
+        live_[Object] = LiveSample{&bucket, bytes}; //last to allocate, the counters only change once it is in
+        ++bucket.inuse_count_;
+        bucket.inuse_bytes_ += bytes;
+        ++bucket.alloc_count_;
+        bucket.alloc_bytes_ += bytes;
+    }
+    catch (std::bad_alloc &)
+    {
+    }
+}
+
+/**
+ * @brief Forgets a sample when its block is freed
+ *
+ * @param Object Block returned by the client
+ */
+void HeapProfiler::RecordFree(const void *Object)
+{
+    if (live_.empty())
+        return;
+    auto it = live_.find(Object);
+    if (it == live_.end())
+        return;
+    --it->second.bucket_->inuse_count_;
+    it->second.bucket_->inuse_bytes_ -= it->second.bytes_;
+    live_.erase(it);
+}
+
+/**
+ * @brief Mean sampling interval
+ *
+ * @return size_t Bytes
+ */
+size_t HeapProfiler::SampleBytes() const
+{
+    return sampleBytes_;
+}
+
+/**
+ * @brief Number of sampled blocks that are still alive
+ *
+ * @return unsigned Count
+ */
+unsigned HeapProfiler::LiveSamples() const
+{
+    return static_cast<unsigned>(live_.size());
+}
+
+/**
+ * @brief Turns a return address into a readable frame name
+ *
+ * @param address Return address
+ * @return std::string Demangled function name, or the address in hex
+ */
+static std::string FrameName(void *address)
+{
+    char hex[32];
+    snprintf(hex, sizeof(hex), "%p", address);
+#if HAS_BACKTRACE
+    char **symbols = backtrace_symbols(&address, 1);
+    if (!symbols)
+        return hex;
+    std::string name = hex;
+    //Format is "binary(mangled+0xoffset) [0xaddress]"
+    const char *open = strchr(symbols[0], '(');
+    const char *plus = open ? strchr(open, '+') : nullptr;
+    if (open && plus && plus > open + 1)
+    {
+        std::string mangled(open + 1, plus);
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+        name = status == 0 ? demangled : mangled;
+        free(demangled);
+    }
+    free(symbols);
+    //';' separates frames in the folded format
+    for (char &c : name)
+        if (c == ';')
+            c = ':';
+    return name;
+#else
+    return hex;
+#endif
+}
+
+/**
+ * @brief Writes the estimated live bytes of each stack trace as folded stacks (root first)
+ *
+ * @param path File to write
+ * @return true Written
+ * @return false The file couldn't be opened
+ */
+bool HeapProfiler::WriteFoldedStacks(const char *path) const
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    std::map<void *, std::string> names; //symbolise every address once
+    for (const auto &entry : buckets_)
+    {
+        const Bucket &bucket = entry.second;
+        if (!bucket.inuse_count_)
+            continue;
+
+        std::string line;
+        for (auto frame = entry.first.rbegin(); frame != entry.first.rend(); ++frame)
+        {
+            auto name = names.find(*frame);
+            if (name == names.end())
+                name = names.emplace(*frame, FrameName(*frame)).first;
+            if (!line.empty())
+                line += ';';
+            line += name->second;
+        }
+        if (line.empty())
+            line = "[unknown]";
+
+        double estimate = static_cast<double>(bucket.inuse_bytes_) * Scale(bucket.inuse_bytes_ / bucket.inuse_count_);
+        fprintf(file, "%s %llu\n", line.c_str(), static_cast<unsigned long long>(estimate + 0.5));
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Writes the samples in the legacy text heap profile format understood by pprof.
+ *  pprof undoes the sampling itself from the heap_v2 rate, so raw sample counts are written.
+ *
+ * @param path File to write
+ * @return true Written
+ * @return false The file couldn't be opened
+ */
+bool HeapProfiler::WriteHeapProfile(const char *path) const
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    Bucket total{0, 0, 0, 0};
+    for (const auto &entry : buckets_)
+    {
+        total.inuse_count_ += entry.second.inuse_count_;
+        total.inuse_bytes_ += entry.second.inuse_bytes_;
+        total.alloc_count_ += entry.second.alloc_count_;
+        total.alloc_bytes_ += entry.second.alloc_bytes_;
+    }
+    fprintf(file, "heap profile: %u: %zu [%u: %zu] @ heap_v2/%zu\n", total.inuse_count_, total.inuse_bytes_,
+            total.alloc_count_, total.alloc_bytes_, sampleBytes_);
+
+    for (const auto &entry : buckets_)
+    {
+        const Bucket &bucket = entry.second;
+        fprintf(file, "%u: %zu [%u: %zu] @", bucket.inuse_count_, bucket.inuse_bytes_, bucket.alloc_count_, bucket.alloc_bytes_);
+        for (void *frame : entry.first)
+            fprintf(file, " %p", frame);
+        fprintf(file, "\n");
+    }
+
+    //pprof needs the memory map to symbolise the addresses
+    fprintf(file, "\nMAPPED_LIBRARIES:\n");
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (maps)
+    {
+        char buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), maps)) > 0)
+            fwrite(buffer, 1, read, file);
+        fclose(maps);
+    }
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file HeapProfiler.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of HeapProfiler, a sampling heap profiler that can be
+ * attached to one or more ObjectAllocators. On average one allocation per SampleBytes bytes has its
+ * stack trace recorded, and the live samples can be written as folded stacks or as a pprof heap profile.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef HEAPPROFILERH
+#define HEAPPROFILERH
+//---------------------------------------------------------------------------
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+static const size_t DEFAULT_SAMPLE_BYTES = 512 * 1024; // same default as tcmalloc
+static const unsigned DEFAULT_SAMPLE_DEPTH = 32;
+
+/*!
+  Samples allocations at exponentially distributed byte intervals (a Poisson process over the
+  allocated bytes) and keeps the stack traces of the samples that are still alive.
+
+  Not thread-safe: share it only between allocators used by the same thread.
+*/
+class HeapProfiler
+{
+  public:
+      // SampleBytes is the mean number of bytes between two samples, MaxDepth the deepest stack kept
+    HeapProfiler(size_t SampleBytes = DEFAULT_SAMPLE_BYTES, unsigned MaxDepth = DEFAULT_SAMPLE_DEPTH);
+
+      // Counts bytes towards the next sample, true if this allocation must be recorded
+    bool ShouldSample(size_t bytes)
+    {
+      if (countdown_ > bytes)
+      {
+        countdown_ -= bytes;
+        return false;
+      }
+      countdown_ = NextInterval();
+      return true;
+    }
+
+      // Records the stack trace of a sampled allocation (the sample is dropped if there is no memory for it)
+    void RecordAllocation(const void *Object, size_t bytes) noexcept;
+
+      // Forgets a sample when its block is freed (cheap if Object was never sampled)
+    void RecordFree(const void *Object);
+
+      // Writes one "frame;frame;...;frame bytes" line per live stack (for flamegraph.pl and friends)
+    bool WriteFoldedStacks(const char *path) const;
+
+      // Writes the live samples in the pprof legacy heap profile format ("heap_v2")
+    bool WriteHeapProfile(const char *path) const;
+
+    size_t SampleBytes() const;   // mean sampling interval in bytes
+    unsigned LiveSamples() const; // number of sampled blocks still alive
+
+      // Prevent copy construction and assignment
+    HeapProfiler(const HeapProfiler &) = delete;            //!< Do not implement!
+    HeapProfiler &operator=(const HeapProfiler &) = delete; //!< Do not implement!
+
+  private:
+    typedef std::vector<void *> Stack;
+
+    /*!
+      Counters of all samples taken at the same stack trace
+    */
+    struct Bucket
+    {
+      unsigned inuse_count_; //!< sampled blocks still alive
+      size_t inuse_bytes_;   //!< bytes of the sampled blocks still alive
+      unsigned alloc_count_; //!< sampled blocks ever allocated
+      size_t alloc_bytes_;   //!< bytes of the sampled blocks ever allocated
+    };
+
+    /*!
+      A sampled block that has not been freed yet
+    */
+    struct LiveSample
+    {
+      Bucket *bucket_; //!< stack the block was allocated at
+      size_t bytes_;   //!< size of the block
+    };
+
+    size_t sampleBytes_;                                 // mean interval between samples
+    unsigned maxDepth_;                                  // deepest stack recorded
+    size_t countdown_;                                   // bytes left before the next sample
+    unsigned long long rng_;                             // xorshift state for the intervals
+    std::map<Stack, Bucket> buckets_;                    // samples grouped by stack trace
+    std::unordered_map<const void *, LiveSample> live_;  // sampled blocks still alive
+
+    size_t NextInterval();
+    double Scale(size_t bytes) const; // inverse of the probability of sampling a block of this size
+};
+
+#endif
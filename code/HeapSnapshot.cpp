@@ -0,0 +1,75 @@
+/**
+ * @file HeapSnapshot.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements the difference of two heap snapshots.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "HeapSnapshot.h"
+#include <algorithm>
+
+/**
+ * @brief Gets the delta of a label, growing the table on demand
+ *
+ * @param deltas Deltas indexed by label id
+ * @param label Label id
+ * @return OASnapshotDelta& The delta
+ */
+static OASnapshotDelta &DeltaOf(std::vector<OASnapshotDelta> &deltas, unsigned label)
+{
+    if (label >= deltas.size())
+        deltas.resize(label + 1);
+    deltas[label].Label_ = label;
+    return deltas[label];
+}
+
+/**
+ * @brief Compares two snapshots of the same allocator with one merge of their sorted blocks
+ *
+ * @param a Earlier snapshot
+ * @param b Later snapshot
+ * @return std::vector<OASnapshotDelta> Labels whose blocks changed, largest NetBytes_ first
+ */
+std::vector<OASnapshotDelta> DiffSnapshots(const OASnapshot &a, const OASnapshot &b)
+{
+    std::vector<OASnapshotDelta> deltas;
+    std::vector<OASnapshotEntry>::const_iterator ia = a.Live_.begin(), ib = b.Live_.begin();
+    while (ia != a.Live_.end() || ib != b.Live_.end())
+    {
+        if (ib == b.Live_.end() || (ia != a.Live_.end() && ia->AllocNum_ < ib->AllocNum_))
+        {
+            ++DeltaOf(deltas, ia->Label_).Freed_; //gone since a
+            ++ia;
+        }
+        else if (ia == a.Live_.end() || ib->AllocNum_ < ia->AllocNum_)
+        {
+            OASnapshotDelta &delta = DeltaOf(deltas, ib->Label_); //new since a
+            if (!delta.Allocated_++)
+                delta.FirstAllocNum_ = ib->AllocNum_;
+            ++ib;
+        }
+        else
+        {
+            ++ia; //alive in both
+            ++ib;
+        }
+    }
+
+    std::vector<OASnapshotDelta> changed;
+    for (OASnapshotDelta &delta : deltas)
+    {
+        if (!delta.Allocated_ && !delta.Freed_)
+            continue;
+        delta.NetBytes_ = (static_cast<long long>(delta.Allocated_) - static_cast<long long>(delta.Freed_)) * static_cast<long long>(b.ObjectSize_);
+        changed.push_back(delta);
+    }
+    std::stable_sort(changed.begin(), changed.end(), [](const OASnapshotDelta &x, const OASnapshotDelta &y) {
+        return x.NetBytes_ > y.NetBytes_;
+    });
+    return changed;
+}
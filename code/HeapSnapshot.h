@@ -0,0 +1,84 @@
+/**
+ * @file HeapSnapshot.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides OASnapshot, the set of live blocks of an allocator at one moment, and
+ * the per-label difference between two snapshots, to find slow growth in long running programs.
+ * OAStaleStats summarises the live blocks of a label that are older than a threshold.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef HEAPSNAPSHOTH
+#define HEAPSNAPSHOTH
+//---------------------------------------------------------------------------
+
+#include <cstddef>
+#include <vector>
+
+/*!
+  One live block of a snapshot
+*/
+struct OASnapshotEntry
+{
+  unsigned AllocNum_; //!< allocation number of the block
+  unsigned Label_;    //!< LabelTable id of its label (0 if unlabelled or labels aren't tracked)
+};
+
+/*!
+  Live blocks of an allocator, sorted by allocation number (8 bytes per live block)
+*/
+struct OASnapshot
+{
+  /*!
+    Constructor
+  */
+  OASnapshot() : Allocations_(0), ObjectSize_(0) {};
+
+  unsigned Allocations_;               //!< allocations made when the snapshot was taken
+  size_t ObjectSize_;                  //!< size of the blocks
+  std::vector<OASnapshotEntry> Live_;  //!< the live blocks
+};
+
+/*!
+  How the live blocks of one label changed between two snapshots
+*/
+struct OASnapshotDelta
+{
+  /*!
+    Constructor
+  */
+  OASnapshotDelta() : Label_(0), Allocated_(0), Freed_(0), NetBytes_(0), FirstAllocNum_(0) {};
+
+  unsigned Label_;          //!< LabelTable id of the label
+  unsigned Allocated_;      //!< blocks live in the later snapshot but not in the earlier one
+  unsigned Freed_;          //!< blocks live in the earlier snapshot but not in the later one
+  long long NetBytes_;      //!< (Allocated_ - Freed_) * object size
+  unsigned FirstAllocNum_;  //!< allocation number of the oldest block counted in Allocated_ (0=none)
+};
+
+/*!
+  Live blocks of one label older than the threshold given to ObjectAllocator::DumpStaleObjects
+*/
+struct OAStaleStats
+{
+  /*!
+    Constructor
+  */
+  OAStaleStats() : Label_(0), Objects_(0), Bytes_(0), OldestAge_(0), Oldest_(nullptr) {};
+
+  unsigned Label_;               //!< LabelTable id of the label
+  unsigned Objects_;             //!< stale blocks of the label
+  size_t Bytes_;                 //!< bytes of those blocks
+  unsigned long long OldestAge_; //!< age of the oldest one
+  const void *Oldest_;           //!< the oldest one
+};
+
+  // Per-label changes from a to b, largest growth first (labels that didn't change are left out)
+std::vector<OASnapshotDelta> DiffSnapshots(const OASnapshot &a, const OASnapshot &b);
+
+#endif
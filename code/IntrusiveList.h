@@ -0,0 +1,136 @@
+/**
+ * @file IntrusiveList.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides IntrusiveList, a doubly linked list whose links live inside the objects,
+ * so objects from a pool can be listed without any allocation.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef INTRUSIVELISTH
+#define INTRUSIVELISTH
+//---------------------------------------------------------------------------
+
+#include <cstddef>
+
+/*!
+  Links of an object in one IntrusiveList. An object derives from ListHook<Tag> once per list it can
+  be on at the same time, each list with its own Tag, e.g.
+
+    struct Employee : ListHook<>, ListHook<struct ByDepartment> { ... };
+    IntrusiveList<Employee> all;
+    IntrusiveList<Employee, ByDepartment> department;
+*/
+template <typename Tag = void>
+struct ListHook
+{
+  ListHook() : next_(nullptr), prev_(nullptr) {}
+
+  ListHook *next_; //!< next object, null when not listed
+  ListHook *prev_; //!< previous object
+};
+
+/*!
+  Circular doubly linked list of T through its ListHook<Tag>. The list owns nothing: inserting and
+  removing never allocate, and the objects are created and freed by the client, typically with
+  PoolRegistry::New/Delete. Every operation is O(1) except Clear.
+*/
+template <typename T, typename Tag = void>
+class IntrusiveList
+{
+  public:
+    typedef ListHook<Tag> Hook; //!< the links used by this list
+
+    /*!
+      Bidirectional iterator over the objects
+    */
+    class iterator
+    {
+      public:
+        explicit iterator(Hook *hook) : hook_(hook) {}
+        T &operator*() const { return *ToObject(hook_); }
+        T *operator->() const { return ToObject(hook_); }
+        iterator &operator++() { hook_ = hook_->next_; return *this; }
+        iterator &operator--() { hook_ = hook_->prev_; return *this; }
+        bool operator==(const iterator &other) const { return hook_ == other.hook_; }
+        bool operator!=(const iterator &other) const { return hook_ != other.hook_; }
+
+      private:
+        Hook *hook_; //!< current object, or the list's sentinel at the end
+    };
+
+    IntrusiveList() : size_(0) { sentinel_.next_ = sentinel_.prev_ = &sentinel_; }
+
+      // The objects must be unlinked (Clear) before the list goes away
+    ~IntrusiveList() = default;
+
+    void PushFront(T *object) { LinkAfter(&sentinel_, object); } // O(1)
+    void PushBack(T *object) { LinkAfter(sentinel_.prev_, object); } // O(1)
+    void InsertBefore(T *position, T *object) { LinkAfter(ToHook(position)->prev_, object); } // O(1)
+
+      // Unlinks object, which must be on this list
+    void Remove(T *object)
+    {
+      Hook *hook = ToHook(object);
+      hook->prev_->next_ = hook->next_;
+      hook->next_->prev_ = hook->prev_;
+      hook->next_ = hook->prev_ = nullptr;
+      --size_;
+    }
+
+      // Unlinks and returns the first object, null if empty
+    T *PopFront()
+    {
+      if (!size_)
+        return nullptr;
+      T *object = ToObject(sentinel_.next_);
+      Remove(object);
+      return object;
+    }
+
+      // Unlinks every object and passes it to dispose, e.g. PoolRegistry::Delete<T>
+    template <typename Dispose>
+    void Clear(Dispose dispose)
+    {
+      while (T *object = PopFront())
+        dispose(object);
+    }
+
+    T *Front() const { return size_ ? ToObject(sentinel_.next_) : nullptr; }
+    T *Back() const { return size_ ? ToObject(sentinel_.prev_) : nullptr; }
+    static bool IsLinked(const T *object) { return ToHook(const_cast<T *>(object))->next_ != nullptr; }
+    bool Empty() const { return size_ == 0; }
+    size_t Size() const { return size_; }
+
+    iterator begin() { return iterator(sentinel_.next_); }
+    iterator end() { return iterator(&sentinel_); }
+
+      // Prevent copy construction and assignment
+    IntrusiveList(const IntrusiveList &) = delete;            //!< Do not implement!
+    IntrusiveList &operator=(const IntrusiveList &) = delete; //!< Do not implement!
+
+  private:
+    Hook sentinel_; // first and last object's neighbour
+    size_t size_;   // objects listed
+
+    static Hook *ToHook(T *object) { return static_cast<Hook *>(object); }
+    static T *ToObject(Hook *hook) { return static_cast<T *>(hook); }
+
+      // Links object after hook
+    void LinkAfter(Hook *hook, T *object)
+    {
+      Hook *link = ToHook(object);
+      link->prev_ = hook;
+      link->next_ = hook->next_;
+      hook->next_->prev_ = link;
+      hook->next_ = link;
+      ++size_;
+    }
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file LabelTable.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements LabelTable, which interns allocation labels and keeps live usage
+ * counters for each of them.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "LabelTable.h"
+#include "ObjectAllocator.h"
+#include <cstring>
+#include <memory>
+
+static const size_t INITIAL_SLOTS = 16; // must be a power of 2
+
+/**
+ * @brief Construct a new LabelTable, with the NO_LABEL entry in place
+ *
+ */
+LabelTable::LabelTable() : slots_(INITIAL_SLOTS, 0)
+{
+    Entry none{nullptr, 0, OALabelStats(), Clock::now()};
+    entries_.push_back(none); //NO_LABEL is never stored in slots_
+}
+
+/**
+ * @brief Destroy the LabelTable, freeing the interned strings
+ *
+ */
+LabelTable::~LabelTable()
+{
+    for (Entry &entry : entries_)
+        delete[] entry.name_;
+}
+
+/**
+ * @brief FNV-1a hash of a NUL-terminated string
+ *
+ * @param label String to hash
+ * @return size_t Hash value
+ */
+size_t LabelTable::Hash(const char *label)
+{
+    size_t hash = static_cast<size_t>(14695981039346656037ull);
+    while (*label)
+    {
+        hash ^= static_cast<unsigned char>(*label++);
+        hash *= static_cast<size_t>(1099511628211ull);
+    }
+    return hash;
+}
+
+/**
+ * @brief Linear probe for label
+ *
+ * @param label Label to look for
+ * @param hash Hash of label
+ * @return size_t Index of the slot holding label, or of the empty slot where it belongs
+ */
+size_t LabelTable::Probe(const char *label, size_t hash) const
+{
+    size_t mask = slots_.size() - 1;
+    size_t i = hash & mask;
+    while (slots_[i])
+    {
+        const Entry &entry = entries_[slots_[i] - 1];
+        if (entry.hash_ == hash && strcmp(entry.name_, label) == 0)
+            break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * @brief Doubles the number of slots and reinserts every label
+ *
+ */
+void LabelTable::Grow()
+{
+    std::vector<unsigned> slots(slots_.size() * 2, 0);
+    size_t mask = slots.size() - 1;
+    for (unsigned id = 1; id < entries_.size(); ++id)
+    {
+        size_t i = entries_[id].hash_ & mask;
+        while (slots[i])
+            i = (i + 1) & mask;
+        slots[i] = id + 1;
+    }
+    slots_.swap(slots);
+}
+
+/**
+ * @brief Returns the id of label, adding it to the table if it is new
+ *
+ * @param label NUL-terminated label, may be null
+ * @return unsigned Id of the label (NO_LABEL for null)
+ * @exception OAException E_NO_MEMORY No memory
+ */
+unsigned LabelTable::Intern(const char *label)
+{
+    if (!label)
+        return NO_LABEL;
+
+    size_t hash = Hash(label);
+    size_t slot = Probe(label, hash);
+    if (slots_[slot])
+        return slots_[slot] - 1;
+
+    try
+    {
+        if (entries_.size() == entries_.capacity()) //so push_back can't throw once the name is copied
+            entries_.reserve(entries_.size() * 2);
+        if ((entries_.size() + 1) * 2 > slots_.size()) //Keep the load factor under 1/2
+        {
+            Grow();
+            slot = Probe(label, hash);
+        }
+        std::unique_ptr<char[]> name(new char[strlen(label) + 1]);
+        strcpy(name.get(), label);
+        entries_.push_back(Entry{name.get(), hash, OALabelStats(), Clock::now()});
+        name.release(); //owned by the entry now
+    }
+    catch (std::bad_alloc &)
+    {
+        throw OAException(OAException::E_NO_MEMORY, "Label table: No memory available.");
+    }
+    unsigned id = static_cast<unsigned>(entries_.size() - 1);
+    slots_[slot] = id + 1;
+    return id;
+}
+
+/**
+ * @brief Returns the id of label without adding it
+ *
+ * @param label NUL-terminated label, may be null
+ * @return unsigned Id of the label, or NOT_FOUND
+ */
+unsigned LabelTable::Find(const char *label) const
+{
+    if (!label)
+        return NO_LABEL;
+    size_t slot = Probe(label, Hash(label));
+    return slots_[slot] ? slots_[slot] - 1 : NOT_FOUND;
+}
+
+/**
+ * @brief Accounts an allocation made under a label
+ *
+ * @param id Id of the label
+ * @param bytes Size of the allocation
+ */
+void LabelTable::OnAllocate(unsigned id, size_t bytes)
+{
+    OALabelStats &stats = entries_[id].stats_;
+    ++stats.Allocations_;
+    ++stats.ObjectsInUse_;
+    stats.BytesInUse_ += bytes;
+    if (stats.ObjectsInUse_ > stats.MostObjects_)
+        stats.MostObjects_ = stats.ObjectsInUse_;
+}
+
+/**
+ * @brief Accounts a deallocation of a block allocated under a label
+ *
+ * @param id Id of the label
+ * @param bytes Size of the allocation
+ */
+void LabelTable::OnFree(unsigned id, size_t bytes)
+{
+    OALabelStats &stats = entries_[id].stats_;
+    ++stats.Deallocations_;
+    --stats.ObjectsInUse_;
+    stats.BytesInUse_ -= bytes;
+}
+
+/**
+ * @brief Number of labels in the table
+ *
+ * @return unsigned Count, including NO_LABEL
+ */
+unsigned LabelTable::Count() const
+{
+    return static_cast<unsigned>(entries_.size());
+}
+
+/**
+ * @brief Interned string of a label
+ *
+ * @param id Id of the label
+ * @return const char* The label, null for NO_LABEL
+ */
+const char *LabelTable::Name(unsigned id) const
+{
+    return entries_[id].name_;
+}
+
+/**
+ * @brief Counters of a label
+ *
+ * @param id Id of the label
+ * @return OALabelStats Copy of the counters with AllocationRate_ computed
+ */
+OALabelStats LabelTable::Stats(unsigned id) const
+{
+    const Entry &entry = entries_[id];
+    OALabelStats stats = entry.stats_;
+    double seconds = std::chrono::duration<double>(Clock::now() - entry.first_).count();
+    if (seconds > 0.0)
+        stats.AllocationRate_ = stats.Allocations_ / seconds;
+    return stats;
+}
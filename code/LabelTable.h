@@ -0,0 +1,94 @@
+/**
+ * @file LabelTable.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of LabelTable, a small open-addressing hash table that
+ * interns allocation labels and keeps live usage counters for each of them.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef LABELTABLEH
+#define LABELTABLEH
+//---------------------------------------------------------------------------
+
+#include <cstddef>
+#include <chrono>
+#include <vector>
+
+/*!
+  POD that holds the usage of a single allocation label
+*/
+struct OALabelStats
+{
+  /*!
+    Constructor
+  */
+  OALabelStats() : ObjectsInUse_(0), BytesInUse_(0), MostObjects_(0), Allocations_(0),
+                   Deallocations_(0), AllocationRate_(0.0) {};
+
+  unsigned ObjectsInUse_;  //!< number of objects with this label in use by client
+  size_t BytesInUse_;      //!< bytes in use by client under this label
+  unsigned MostObjects_;   //!< most objects with this label in use at one time
+  unsigned Allocations_;   //!< total requests to allocate memory with this label
+  unsigned Deallocations_; //!< total requests to free memory with this label
+  double AllocationRate_;  //!< allocations per second since the label was first seen
+};
+
+/*!
+  Interns labels into small integer ids and accounts usage per id
+*/
+class LabelTable
+{
+  public:
+    static const unsigned NO_LABEL = 0;        //!< id of allocations made without a label
+    static const unsigned NOT_FOUND = ~0u;     //!< returned by Find for unknown labels
+
+    LabelTable();
+    ~LabelTable();
+
+      // Returns the id of label, adding it to the table if it is new (0 for a null label)
+    unsigned Intern(const char *label);
+
+      // Returns the id of label or NOT_FOUND, never adds to the table
+    unsigned Find(const char *label) const;
+
+      // Updates the counters of a label (O(1))
+    void OnAllocate(unsigned id, size_t bytes);
+    void OnFree(unsigned id, size_t bytes);
+
+    unsigned Count() const;                // number of interned labels (including NO_LABEL)
+    const char *Name(unsigned id) const;   // the interned string (null for NO_LABEL)
+    OALabelStats Stats(unsigned id) const; // counters of the label, with the rate filled in
+
+      // Prevent copy construction and assignment
+    LabelTable(const LabelTable &) = delete;            //!< Do not implement!
+    LabelTable &operator=(const LabelTable &) = delete; //!< Do not implement!
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    /*!
+      One interned label
+    */
+    struct Entry
+    {
+      char *name_;               //!< dynamically allocated copy of the label
+      size_t hash_;              //!< hash of name_
+      OALabelStats stats_;       //!< live counters
+      Clock::time_point first_;  //!< when the label was interned
+    };
+
+    std::vector<Entry> entries_; // indexed by id
+    std::vector<unsigned> slots_; // open-addressing table of id + 1 (0 = empty slot)
+
+    static size_t Hash(const char *label);
+    size_t Probe(const char *label, size_t hash) const; // slot holding label, or the empty slot to use
+    void Grow();
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file LifetimeProfile.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements LifetimeProfile and the lifetime histograms it keeps.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "LifetimeProfile.h"
+
+/**
+ * @brief Records one lifetime
+ *
+ * @param lifetime Lifetime to add
+ */
+void OALifetimeHistogram::Add(unsigned long long lifetime)
+{
+    unsigned bucket = 0;
+    while (bucket < BUCKETS - 1 && (lifetime >> bucket)) //number of significant bits
+        ++bucket;
+    ++Counts_[bucket];
+    ++Samples_;
+    Total_ += lifetime;
+    if (lifetime > Longest_)
+        Longest_ = lifetime;
+}
+
+/**
+ * @brief Upper bound of the bucket that holds a percentile
+ *
+ * @param p Percentile between 0 and 1
+ * @return unsigned long long Lifetime that at least p of the samples don't exceed
+ */
+unsigned long long OALifetimeHistogram::Percentile(double p) const
+{
+    if (!Samples_)
+        return 0;
+    unsigned long long wanted = static_cast<unsigned long long>(p * static_cast<double>(Samples_) + 0.5);
+    if (wanted == 0)
+        wanted = 1;
+    unsigned long long seen = 0;
+    for (unsigned i = 0; i < BUCKETS; ++i)
+    {
+        seen += Counts_[i];
+        if (seen >= wanted)
+        {
+            if (i == 0)
+                return 0;
+            unsigned long long bound = i < 64 ? (1ull << i) - 1 : ~0ull;
+            return bound < Longest_ ? bound : Longest_;
+        }
+    }
+    return Longest_;
+}
+
+/**
+ * @brief Construct a new, empty LifetimeProfile
+ *
+ */
+LifetimeProfile::LifetimeProfile()
+{
+    longest_.reserve(LONGEST_KEPT + 1);
+}
+
+/**
+ * @brief Makes room for the histogram of a label, before a block of that label is handed out
+ *
+ * @param label Label id
+ * @exception std::bad_alloc No memory
+ */
+void LifetimeProfile::Reserve(unsigned label)
+{
+    if (label >= labels_.size())
+        labels_.resize(label + 1);
+}
+
+/**
+ * @brief Records the lifetime of a block
+ *
+ * @param label Label id of the block, Reserve'd when it was allocated
+ * @param name Interned name of the label
+ * @param birth When the block was allocated
+ * @param lifetime How long the block lived
+ */
+void LifetimeProfile::Add(unsigned label, const char *name, unsigned long long birth, unsigned long long lifetime) noexcept
+{
+    overall_.Add(lifetime);
+    if (label < labels_.size())
+        labels_[label].Add(lifetime);
+
+    if (longest_.size() == LONGEST_KEPT && lifetime <= longest_.back().Lifetime_)
+        return; //not one of the longest
+    OALongLived entry{lifetime, birth, name};
+    auto it = longest_.begin();
+    while (it != longest_.end() && it->Lifetime_ >= lifetime)
+        ++it;
+    longest_.insert(it, entry); //within the capacity reserved by the constructor
+    if (longest_.size() > LONGEST_KEPT)
+        longest_.pop_back();
+}
+
+/**
+ * @brief Histogram of every block of the allocator
+ *
+ * @return const OALifetimeHistogram& The histogram
+ */
+const OALifetimeHistogram &LifetimeProfile::Overall() const
+{
+    return overall_;
+}
+
+/**
+ * @brief Histogram of the blocks of one label
+ *
+ * @param label Label id
+ * @return OALifetimeHistogram The histogram (empty if nothing of that label was freed)
+ */
+OALifetimeHistogram LifetimeProfile::ByLabel(unsigned label) const
+{
+    if (label >= labels_.size())
+        return OALifetimeHistogram();
+    return labels_[label];
+}
+
+/**
+ * @brief The longest-lived blocks freed so far
+ *
+ * @return const std::vector<OALongLived>& Up to LONGEST_KEPT entries, longest first
+ */
+const std::vector<OALongLived> &LifetimeProfile::Longest() const
+{
+    return longest_;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file LifetimeProfile.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of LifetimeProfile, which collects histograms of how long
+ * blocks live (per allocator and per label) and remembers the longest-lived blocks.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef LIFETIMEPROFILEH
+#define LIFETIMEPROFILEH
+//---------------------------------------------------------------------------
+
+#include <vector>
+
+/*!
+  Histogram of lifetimes with power-of-two buckets
+*/
+struct OALifetimeHistogram
+{
+  static const unsigned BUCKETS = 65; //!< bucket 0 holds 0, bucket i holds [2^(i-1), 2^i)
+
+  /*!
+    Constructor
+  */
+  OALifetimeHistogram() : Counts_(), Samples_(0), Total_(0), Longest_(0) {};
+
+  unsigned long long Counts_[BUCKETS]; //!< number of lifetimes in each bucket
+  unsigned long long Samples_;         //!< number of lifetimes recorded
+  unsigned long long Total_;           //!< sum of the lifetimes (for the mean)
+  unsigned long long Longest_;         //!< longest lifetime recorded
+
+  void Add(unsigned long long lifetime);             // records one lifetime
+  unsigned long long Percentile(double p) const;     // upper bound of the bucket holding the p-th percentile (0..1)
+};
+
+/*!
+  One of the longest-lived blocks seen so far
+*/
+struct OALongLived
+{
+  unsigned long long Lifetime_; //!< how long the block lived
+  unsigned long long Birth_;    //!< when it was allocated (same unit as Lifetime_)
+  const char *Label_;           //!< its label (null if unlabelled or labels aren't tracked)
+};
+
+/*!
+  Lifetime histograms of an allocator and of each of its labels
+*/
+class LifetimeProfile
+{
+  public:
+    static const unsigned LONGEST_KEPT = 8; //!< how many of the longest-lived blocks are remembered
+
+    LifetimeProfile();
+
+      // Makes room for the histogram of label, so Add of its blocks never allocates (throws std::bad_alloc)
+    void Reserve(unsigned label);
+
+      // Records the lifetime of a block allocated under label (name must outlive the profile)
+    void Add(unsigned label, const char *name, unsigned long long birth, unsigned long long lifetime) noexcept;
+
+    const OALifetimeHistogram &Overall() const;        // every block of the allocator
+    OALifetimeHistogram ByLabel(unsigned label) const; // blocks of one label
+    const std::vector<OALongLived> &Longest() const;   // longest first
+
+  private:
+    OALifetimeHistogram overall_;              // every block
+    std::vector<OALifetimeHistogram> labels_;  // indexed by label id, grown by Reserve
+    std::vector<OALongLived> longest_;         // sorted, longest first
+};
+
+#endif
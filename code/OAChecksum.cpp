@@ -0,0 +1,163 @@
+/**
+ * @file OAChecksum.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements CRC32C with the CPU's instruction, picked at run time, and a table
+ * driven fallback.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "OAChecksum.h"
+#include <atomic>
+#include <cstring>
+
+#define OA_CRC_SSE42 OA_CRC_INLINE // the header has the SSE4.2 loop
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h> // __crc32cd, __crc32cb
+#define OA_CRC_ARM 1
+#else
+#define OA_CRC_ARM 0
+#endif
+
+static const unsigned CASTAGNOLI = 0x82F63B78u; // CRC32C polynomial, bit-reversed
+
+typedef unsigned (*CRCFUNCTION)(unsigned, const unsigned char *, size_t);
+
+/**
+ * @brief Table of the CRC of every byte, built on first use
+ *
+ * @return const unsigned* 256 entries
+ */
+static const unsigned *Table()
+{
+    static const struct Entries
+    {
+        Entries()
+        {
+            for (unsigned byte = 0; byte < 256; ++byte)
+            {
+                unsigned crc = byte;
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = crc & 1 ? (crc >> 1) ^ CASTAGNOLI : crc >> 1;
+                entries_[byte] = crc;
+            }
+        }
+        unsigned entries_[256];
+    } table;
+    return table.entries_;
+}
+
+/**
+ * @brief CRC32C a byte at a time from the table
+ *
+ * @param crc CRC so far
+ * @param data Bytes
+ * @param size Number of bytes
+ * @return unsigned Updated CRC
+ */
+static unsigned SoftwareCrc(unsigned crc, const unsigned char *data, size_t size)
+{
+    const unsigned *table = Table();
+    while (size--)
+        crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#if OA_CRC_SSE42
+/**
+ * @brief CRC32C with the SSE4.2 instruction, 8 bytes at a time
+ *
+ * @param crc CRC so far
+ * @param data Bytes
+ * @param size Number of bytes
+ * @return unsigned Updated CRC
+ */
+__attribute__((target("sse4.2"))) static unsigned HardwareCrc(unsigned crc, const unsigned char *data, size_t size)
+{
+    return OACrc32cInline(crc, data, size);
+}
+#elif OA_CRC_ARM
+/**
+ * @brief CRC32C with the ARMv8 CRC32 instructions, 8 bytes at a time
+ *
+ * @param crc CRC so far
+ * @param data Bytes
+ * @param size Number of bytes
+ * @return unsigned Updated CRC
+ */
+static unsigned HardwareCrc(unsigned crc, const unsigned char *data, size_t size)
+{
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        unsigned long long word;
+        memcpy(&word, data, 8);
+        crc = __crc32cd(crc, word);
+    }
+    while (size--)
+        crc = __crc32cb(crc, *data++);
+    return crc;
+}
+#endif
+
+/**
+ * @brief The implementation this CPU can run
+ *
+ * @return CRCFUNCTION HardwareCrc or SoftwareCrc
+ */
+static CRCFUNCTION Select()
+{
+#if OA_CRC_SSE42
+    __builtin_cpu_init(); //may run from a static constructor, before libgcc has run its own
+    if (__builtin_cpu_supports("sse4.2"))
+        return HardwareCrc;
+#elif OA_CRC_ARM
+    return HardwareCrc; //the compiler was told the CPU has it
+#endif
+    return SoftwareCrc;
+}
+
+static unsigned Resolve(unsigned crc, const unsigned char *data, size_t size);
+static std::atomic<CRCFUNCTION> implementation{Resolve}; // constant initialised, so usable by static pools
+
+/**
+ * @brief First call: picks the implementation for the next ones
+ *
+ * @param crc CRC so far
+ * @param data Bytes
+ * @param size Number of bytes
+ * @return unsigned Updated CRC
+ */
+static unsigned Resolve(unsigned crc, const unsigned char *data, size_t size)
+{
+    CRCFUNCTION function = Select();
+    implementation.store(function, std::memory_order_relaxed);
+    return function(crc, data, size);
+}
+
+/**
+ * @brief Continues a CRC32C over a buffer
+ *
+ * @param crc CRC so far (no inversion is applied)
+ * @param data Bytes
+ * @param size Number of bytes
+ * @return unsigned Updated CRC
+ */
+unsigned OACrc32c(unsigned crc, const void *data, size_t size)
+{
+    return implementation.load(std::memory_order_relaxed)(crc, static_cast<const unsigned char *>(data), size);
+}
+
+/**
+ * @brief Tells whether the CRC32C instruction is used
+ *
+ * @return true Hardware
+ * @return false Table
+ */
+bool OACrc32cHardware()
+{
+    return Select() != SoftwareCrc;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file OAChecksum.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the CRC32C (Castagnoli) checksum used to protect block metadata. It uses
+ * the SSE4.2 (x86-64) or CRC32 (AArch64) instructions when the CPU has them, and a table otherwise.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef OACHECKSUMH
+#define OACHECKSUMH
+//---------------------------------------------------------------------------
+
+#include <cstddef>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cstring>     // memcpy
+#include <nmmintrin.h> // _mm_crc32_u64/u32/u16/u8
+#define OA_CRC_INLINE 1
+#else
+#define OA_CRC_INLINE 0
+#endif
+
+// Continues the CRC32C crc over size bytes of data, without the usual inversions: the standard
+// checksum of a buffer is ~OACrc32c(~0u, data, size)
+unsigned OACrc32c(unsigned crc, const void *data, size_t size);
+
+// true if OACrc32c uses the CPU's CRC32C instruction
+bool OACrc32cHardware();
+
+#if OA_CRC_INLINE
+// OACrc32c with the SSE4.2 instruction, for the few bytes of a block's metadata: inlined into callers
+// compiled for SSE4.2, so it costs a handful of instructions rather than an indirect call. Only call
+// it when OACrc32cHardware() is true
+__attribute__((target("sse4.2"))) inline unsigned OACrc32cInline(unsigned crc, const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    unsigned long long wide = crc;
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+        unsigned long long word;
+        memcpy(&word, bytes, 8); //metadata isn't always 8-byte aligned
+        wide = _mm_crc32_u64(wide, word);
+    }
+    crc = static_cast<unsigned>(wide);
+    if (size & 4) //the rest in at most three steps, not a byte at a time
+    {
+        unsigned word;
+        memcpy(&word, bytes, 4);
+        crc = _mm_crc32_u32(crc, word);
+        bytes += 4;
+    }
+    if (size & 2)
+    {
+        unsigned short half;
+        memcpy(&half, bytes, 2);
+        crc = _mm_crc32_u16(crc, half);
+        bytes += 2;
+    }
+    if (size & 1)
+        crc = _mm_crc32_u8(crc, *bytes);
+    return crc;
+}
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file OAPoison.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file wraps the AddressSanitizer and Valgrind memcheck client requests that mark pool
+ * memory as inaccessible (poisoned) or accessible. Without a sanitizer they compile to nothing.
+ * AddressSanitizer is detected from the compiler, Valgrind support needs -DOA_VALGRIND=1 and
+ * the valgrind headers.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef OAPOISONH
+#define OAPOISONH
+//---------------------------------------------------------------------------
+
+#include <cstddef>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define OA_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define OA_ASAN 1
+#endif
+#endif
+#ifndef OA_ASAN
+#define OA_ASAN 0
+#endif
+
+#ifndef OA_VALGRIND
+#define OA_VALGRIND 0
+#endif
+
+#if OA_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+#if OA_VALGRIND
+#include <valgrind/memcheck.h>
+#endif
+
+#define OA_POISONING (OA_ASAN || OA_VALGRIND) //!< a sanitizer can be told about pool memory
+
+/**
+ * @brief Marks memory the client must not touch
+ *
+ * @param address Start of the region
+ * @param size Size of the region
+ */
+inline void OAPoisonRegion(const void *address, size_t size)
+{
+#if OA_ASAN
+    ASAN_POISON_MEMORY_REGION(address, size);
+#endif
+#if OA_VALGRIND
+    VALGRIND_MAKE_MEM_NOACCESS(address, size);
+#endif
+    (void)address;
+    (void)size;
+}
+
+/**
+ * @brief Marks memory as accessible again
+ *
+ * @param address Start of the region
+ * @param size Size of the region
+ */
+inline void OAUnpoisonRegion(const void *address, size_t size)
+{
+#if OA_ASAN
+    ASAN_UNPOISON_MEMORY_REGION(address, size);
+#endif
+#if OA_VALGRIND
+    VALGRIND_MAKE_MEM_DEFINED(address, size);
+#endif
+    (void)address;
+    (void)size;
+}
+
+/**
+ * @brief Tells whether an address is poisoned, without reporting an error (AddressSanitizer only)
+ *
+ * @param address Address to check
+ * @return true Poisoned
+ * @return false Accessible, or the check isn't available
+ */
+inline bool OAIsPoisoned(const void *address)
+{
+#if OA_ASAN
+    return __asan_address_is_poisoned(address) != 0;
+#else
+    (void)address;
+    return false;
+#endif
+}
+
+#endif
@@ -12,10 +12,40 @@
  */
 
 #include "ObjectAllocator.h"
+#include "HeapProfiler.h"
+#include "PageProvisioner.h"
+#include "PageReclaimer.h"
+#include "PageCache.h"
+#include "OAPoison.h"
+#include "OAChecksum.h"
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
+#include <chrono>
+#include <new>
+#include <numeric>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h> // iovec
+#else
+struct iovec //same layout as POSIX, for platforms without readv/writev
+{
+    void *iov_base;
+    size_t iov_len;
+};
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#endif
 
 #define PTR_SIZE sizeof(void *)
 
+static const size_t OS_PAGE_SIZE = 4096; //Alignment of PageBytes_ pages, enough for them to cover whole OS pages
+
+static const unsigned ADAPTIVE_TARGET_PAGES = 8; //Adaptive mode aims for the peak usage to fit in this many pages
+
+static const unsigned LIVE_SEED = 0xFFFFFFFFu; //CRC32C seeds of live and free blocks, so a checksum tells which state it was sealed in
+static const unsigned FREE_SEED = 0x5A5A5A5Au;
+
 /**
  * @brief Function that calculates the new size required after accounting for alignment
  * 
@@ -39,87 +69,757 @@ size_t align(size_t sz, size_t alignment)
  * @param config the information needed for the allocator 
  */
 ObjectAllocator::ObjectAllocator(size_t ObjectSize, const OAConfig &config)
-    : configuration{config}
+    : configuration{config}, pageInfoSize{0}, pageAlignment{0}, recentMostObjects{0}, recentReleases{0}, churned{false},
+      tagSize{0}, labels{nullptr}, profiler{nullptr}, lifetimes{nullptr},
+      oomHandler{nullptr}, inOOMHandler{false}, provisioner{nullptr}, sparePage{nullptr}, sparePending{false},
+      spareObjects{0}, spareDebug{false}, reclaimer{nullptr}, pageCache{nullptr}, pageTemplate{nullptr}, templateObjects{0},
+      poisoning{OA_POISONING && config.Poison_ && !config.UseCPPMemManager_},
+      checksums{config.Checksums_ && !config.UseCPPMemManager_}, hardwareCrc{OA_CRC_INLINE && checksums && OACrc32cHardware()},
+      freeMetadata{0}, freeSeed{0}
 {
     PageList_ = nullptr;
     FreeList_ = nullptr;
+    if (config.PageBytes_) //the page size is fixed in bytes
+        configuration.AdaptivePages_ = false;
+    if (configuration.AdaptivePages_) //pages have different sizes, each page records its own object count
+    {
+        if (configuration.MinObjectsPerPage_ == 0 || configuration.MinObjectsPerPage_ > config.ObjectsPerPage_)
+            configuration.MinObjectsPerPage_ = config.ObjectsPerPage_ ? config.ObjectsPerPage_ : 1;
+        if (configuration.MaxObjectsPerPage_ < config.ObjectsPerPage_)
+            configuration.MaxObjectsPerPage_ = config.ObjectsPerPage_;
+    }
     //calculate and inits OAStats
     stats.ObjectSize_ = ObjectSize;
-    size_t unalignedPageHeader = PTR_SIZE + config.HBlockInfo_.size_ + config.PadBytes_;
-    pageHeader = align(unalignedPageHeader, config.Alignment_); //header of the page NOT blocks
-    configuration.LeftAlignSize_ = static_cast<unsigned int>(pageHeader - unalignedPageHeader);
-    dataSize = align(ObjectSize + config.PadBytes_ * 2 + config.HBlockInfo_.size_, config.Alignment_);
-    stats.PageSize_ = pageHeader + dataSize * (config.ObjectsPerPage_ - 1) + ObjectSize + config.PadBytes_;
-    totalDataSize = dataSize * (config.ObjectsPerPage_ - 1) + ObjectSize + config.PadBytes_;
+    OALayout layout = Layout(ObjectSize, configuration);
+    if (!layout.ObjectsPerPage_)
+        throw OAException(OAException::E_NO_MEMORY, "PageBytes_ is too small for a single object!");
+    pageHeader = layout.PageHeader_; //header of the page NOT blocks
+    dataSize = layout.BlockSize_;
+    tagSize = layout.TagSize_;
+    pageInfoSize = layout.PageInfoSize_;
+    pageAlignment = layout.PageAlignment_;
+    configuration.LeftAlignSize_ = layout.LeftAlignSize_;
+    configuration.InterAlignSize_ = layout.InterAlignSize_;
+    SetObjectsPerPage(layout.ObjectsPerPage_);
+    if (checksums && configuration.HBlockInfo_.type_ != OAConfig::hbExtended) //pages start zeroed and Free zeroes what it changes
+    {
+        static const unsigned char zero = 0;
+        freeMetadata = tagSize - offsetof(BlockTag, label_) + configuration.HBlockInfo_.size_;
+        freeSeed = FREE_SEED;
+        for (size_t i = 0; i < freeMetadata; ++i)
+            freeSeed = OACrc32c(freeSeed, &zero, 1);
+    }
 
-    //Calculates interAlignment and inits config
-    size_t midBlockSize = ObjectSize + config.PadBytes_ * 2 + static_cast<size_t>(config.HBlockInfo_.size_);
-    configuration.InterAlignSize_ = static_cast<unsigned int>(align(midBlockSize, configuration.Alignment_) - midBlockSize);
+    try
+    {
+        if (config.TrackLabels_)
+            labels = new LabelTable;
+        if (config.Lifetimes_ != OAConfig::ltNone)
+            lifetimes = new LifetimeProfile;
+    }
+    catch (std::bad_alloc &)
+    {
+        delete labels;
+        throw OAException(OAException::E_NO_MEMORY, "Tracking: No memory available.");
+    }
 
     //Allocates a starting page
-    AllocateNewPage(PageList_);
+    try
+    {
+        AllocateNewPage();
+    }
+    catch (OAException &)
+    {
+        delete labels;
+        delete lifetimes;
+        delete[] pageTemplate;
+        throw;
+    }
 }
 
 /**
- * @brief Constructs a new page
+ * @brief Computes the layout of the pages of an allocator, without creating it
+ * 
+ * @param ObjectSize size of each object
+ * @param config the configuration of the allocator
+ * @return OALayout The sizes of the page header, blocks and pages
+ */
+OALayout ObjectAllocator::Layout(size_t ObjectSize, const OAConfig &config)
+{
+    OALayout layout;
+    if (config.AdaptivePages_ && !config.PageBytes_)
+        layout.PageInfoSize_ = PTR_SIZE;
+
+    //Offsets are aligned within the page, IOAlignment_ also aligns the page itself so the addresses are aligned
+    size_t alignment = config.IOAlignment_ > config.Alignment_ ? config.IOAlignment_ : config.Alignment_;
+    if (config.TrackLabels_ || config.Lifetimes_ != OAConfig::ltNone || config.Checksums_)
+    {
+        //The tag sits right before the header: with objects aligned for it, the bytes after the tag
+        //round header and pads up to a multiple of its alignment, so every tag is aligned too
+        alignment = alignment ? std::lcm(alignment, alignof(BlockTag)) : alignof(BlockTag);
+        layout.TagSize_ = sizeof(BlockTag) + align(config.HBlockInfo_.size_ + config.PadBytes_, alignof(BlockTag)) -
+                          (config.HBlockInfo_.size_ + config.PadBytes_);
+    }
+    size_t unalignedPageHeader = PTR_SIZE + layout.PageInfoSize_ + layout.TagSize_ + config.HBlockInfo_.size_ + config.PadBytes_;
+    layout.PageHeader_ = align(unalignedPageHeader, alignment);
+    layout.LeftAlignSize_ = static_cast<unsigned int>(layout.PageHeader_ - unalignedPageHeader);
+
+    //Calculates interAlignment
+    size_t midBlockSize = ObjectSize + config.PadBytes_ * 2 + config.HBlockInfo_.size_ + layout.TagSize_;
+    layout.BlockSize_ = align(midBlockSize, alignment);
+    layout.InterAlignSize_ = static_cast<unsigned int>(layout.BlockSize_ - midBlockSize);
+
+    layout.ObjectsPerPage_ = config.ObjectsPerPage_;
+    if (config.PageBytes_) //as many objects as fit in exactly PageBytes_, aligned on an OS page
+    {
+        size_t first = layout.PageHeader_ + ObjectSize + config.PadBytes_; //page with a single object
+        layout.ObjectsPerPage_ = first > config.PageBytes_ ? 0 : static_cast<unsigned>((config.PageBytes_ - first) / layout.BlockSize_ + 1);
+        layout.PageAlignment_ = OS_PAGE_SIZE; //not PageBytes_: the heap would have to over-allocate to align on it
+        if (!layout.ObjectsPerPage_)
+            return layout;
+    }
+
+    layout.PageSize_ = layout.PageHeader_ + layout.BlockSize_ * (layout.ObjectsPerPage_ - 1) + ObjectSize + config.PadBytes_;
+    layout.PageAllocSize_ = config.PageBytes_ ? config.PageBytes_ : layout.PageSize_ + PTR_SIZE;
+    if (config.IOAlignment_ > layout.PageAlignment_)
+        layout.PageAlignment_ = config.IOAlignment_;
+    return layout;
+}
+
+/**
+ * @brief Returns the start of the header block of an object
+ * 
+ * @param obj Start of the client's data
+ * @return unsigned char* Start of the header block (before the left padding)
+ */
+unsigned char *ObjectAllocator::HeaderStart(void *obj) const
+{
+    return reinterpret_cast<unsigned char *>(obj) - configuration.PadBytes_ - configuration.HBlockInfo_.size_;
+}
+
+/**
+ * @brief Returns the hidden tag of an object, which sits in front of its header block
+ * 
+ * @param obj Start of the client's data
+ * @return BlockTag* The tag (only valid when tagSize is not 0)
+ */
+BlockTag *ObjectAllocator::TagOf(void *obj) const
+{
+    return reinterpret_cast<BlockTag *>(HeaderStart(obj) - tagSize);
+}
+
+#if OA_CRC_INLINE
+/**
+ * @brief BlockChecksum with the SSE4.2 instruction inlined: the metadata of a block is hashed in one
+ *  pass (two when an extended header's user-defined bytes are skipped), without an indirect call per range
+ * 
+ * @param crc Seed
+ * @param metadata Tag and header bytes
+ * @param size Number of bytes at metadata
+ * @param rest Header bytes after the user-defined ones (null if none are skipped)
+ * @param restSize Number of bytes at rest
+ * @param link Free list link to include (null for a live block)
+ * @return unsigned The checksum
+ */
+__attribute__((target("sse4.2"))) static unsigned InlineChecksum(unsigned crc, const unsigned char *metadata, size_t size,
+                                                                 const unsigned char *rest, size_t restSize, const void *link)
+{
+    crc = OACrc32cInline(crc, metadata, size);
+    if (rest)
+        crc = OACrc32cInline(crc, rest, restSize);
+    if (link)
+        crc = OACrc32cInline(crc, link, PTR_SIZE);
+    return crc;
+}
+
+/**
+ * @brief CRC32C of the value of a free list link with the SSE4.2 instruction, a single step
+ * 
+ * @param crc CRC so far
+ * @param link The link
+ * @return unsigned Updated CRC
+ */
+__attribute__((target("sse4.2"))) static unsigned InlineLinkChecksum(unsigned crc, GenericObject *link)
+{
+    return OACrc32cInline(crc, &link, PTR_SIZE);
+}
+#endif
+
+/**
+ * @brief CRC32C of the metadata of a block: the label and birth in its tag, its header (except the
+ *  user-defined bytes of an extended header, which belong to the client) and, for a free block, its
+ *  free list link. The seed depends on the state, so a live block's checksum never matches as free.
+ * 
+ * @param obj Start of the client's data
+ * @param free Checksum of obj as a free block (link included) rather than a live one
+ * @return unsigned The checksum
+ */
+unsigned ObjectAllocator::BlockChecksum(void *obj, bool free) const
+{
+    unsigned char *metadata = reinterpret_cast<unsigned char *>(&TagOf(obj)->label_); //label_, birth_, the bytes that align the tag and the header are contiguous
+    unsigned char *header = HeaderStart(obj);
+    size_t skipped = configuration.HBlockInfo_.type_ == OAConfig::hbExtended ? configuration.HBlockInfo_.additional_ : 0; //the user-defined bytes
+    size_t size = static_cast<size_t>(header - metadata) + (skipped ? 0 : configuration.HBlockInfo_.size_);
+    unsigned char *rest = skipped ? header + skipped : nullptr;
+    size_t restSize = skipped ? configuration.HBlockInfo_.size_ - skipped : 0;
+    unsigned crc = free ? FREE_SEED : LIVE_SEED;
+#if OA_CRC_INLINE
+    if (hardwareCrc)
+        return InlineChecksum(crc, metadata, size, rest, restSize, free ? obj : nullptr);
+#endif
+    crc = OACrc32c(crc, metadata, size);
+    if (rest)
+        crc = OACrc32c(crc, rest, restSize);
+    if (free)
+        crc = OACrc32c(crc, obj, PTR_SIZE);
+    return crc;
+}
+
+/**
+ * @brief Tells whether bytes are all zero
+ * 
+ * @param bytes Start
+ * @param size Number of bytes
+ * @return true Every byte is 0
+ */
+static bool AllZero(const unsigned char *bytes, size_t size)
+{
+    unsigned long long any = 0;
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+        unsigned long long word;
+        memcpy(&word, bytes, 8);
+        any |= word;
+    }
+    if (size & 4) //the rest in at most three loads, as OACrc32cInline does
+    {
+        unsigned word;
+        memcpy(&word, bytes, 4);
+        any |= word;
+        bytes += 4;
+    }
+    if (size & 2)
+    {
+        unsigned short half;
+        memcpy(&half, bytes, 2);
+        any |= half;
+        bytes += 2;
+    }
+    if (size & 1)
+        any |= *bytes;
+    return !any;
+}
+
+/**
+ * @brief BlockChecksum(obj, true), in a single step when the tag and header hold the zeros that
+ *  CreatePage and Free leave in a free block: the CRC of those zeros is freeSeed, only the link is
+ *  hashed. Comparing the zeros catches anything the full pass would.
+ * 
+ * @param obj Start of the client's data
+ * @return unsigned The checksum of obj as a free block
+ */
+unsigned ObjectAllocator::FreeChecksum(void *obj) const
+{
+    if (!freeMetadata || !AllZero(reinterpret_cast<unsigned char *>(&TagOf(obj)->label_), freeMetadata))
+        return BlockChecksum(obj, true);
+    return ZeroedFreeChecksum(static_cast<GenericObject *>(obj)->Next);
+}
+
+/**
+ * @brief Checksum of a free block whose tag and header hold zeros (freeMetadata isn't 0), from the
+ *  value of its link: one CRC step, without reading the block back
+ * 
+ * @param link Next free block, as stored in the block
+ * @return unsigned The checksum of the block as a free block
+ */
+unsigned ObjectAllocator::ZeroedFreeChecksum(GenericObject *link) const
+{
+#if OA_CRC_INLINE
+    if (hardwareCrc)
+        return InlineLinkChecksum(freeSeed, link);
+#endif
+    return OACrc32c(freeSeed, &link, PTR_SIZE);
+}
+
+/**
+ * @brief Stores the checksum of a block in its tag, after its metadata changed
+ * 
+ * @param obj Start of the client's data
+ * @param free obj is on the free list
+ */
+void ObjectAllocator::SealBlock(void *obj, bool free) const
+{
+    TagOf(obj)->checksum_ = free ? FreeChecksum(obj) : BlockChecksum(obj, false);
+}
+
+/**
+ * @brief Tells whether the tag of a block holds a valid checksum, as a free or as a live block
+ * 
+ * @param obj Start of the client's data
+ * @return true The metadata is intact
+ * @return false The tag, header or link was overwritten
+ */
+bool ObjectAllocator::ChecksumMatches(void *obj) const
+{
+    unsigned checksum = TagOf(obj)->checksum_;
+    return checksum == BlockChecksum(obj, false) || checksum == FreeChecksum(obj);
+}
+
+/**
+ * @brief Number of blocks on a page
+ * 
+ * @param page Page to look at
+ * @return unsigned Object count recorded in the page (adaptive mode) or ObjectsPerPage_
+ */
+unsigned ObjectAllocator::PageObjects(const GenericObject *page) const
+{
+    if (!pageInfoSize)
+        return configuration.ObjectsPerPage_;
+    return *reinterpret_cast<const unsigned *>(reinterpret_cast<const unsigned char *>(page) + PTR_SIZE);
+}
+
+/**
+ * @brief Size of a page including all headers, padding, etc.
+ * 
+ * @param page Page to look at
+ * @return size_t Size in bytes
+ */
+size_t ObjectAllocator::PageBytes(const GenericObject *page) const
+{
+    return PageBytesFor(PageObjects(page));
+}
+
+/**
+ * @brief Size of a page of a given number of blocks
+ * 
+ * @param objects Number of blocks
+ * @return size_t Size in bytes
+ */
+size_t ObjectAllocator::PageBytesFor(unsigned objects) const
+{
+    return pageHeader + dataSize * (objects - 1) + stats.ObjectSize_ + configuration.PadBytes_;
+}
+
+/**
+ * @brief Checks if an address lies within a page
+ * 
+ * @param obj Address to check
+ * @param page Page to check against
+ * @return true obj is on page
+ * @return false obj is not on page
+ */
+bool ObjectAllocator::IsOnPage(const void *obj, const GenericObject *page) const
+{
+    const unsigned char *address = reinterpret_cast<const unsigned char *>(obj);
+    const unsigned char *start = reinterpret_cast<const unsigned char *>(page);
+    return address >= start && address < start + PageBytes(page);
+}
+
+/**
+ * @brief Sets the number of objects of the pages created from now on, updating the page size
+ * 
+ * @param count Objects per page
+ */
+void ObjectAllocator::SetObjectsPerPage(unsigned count)
+{
+    configuration.ObjectsPerPage_ = count;
+    totalDataSize = dataSize * (count - 1) + stats.ObjectSize_ + configuration.PadBytes_;
+    stats.PageSize_ = PageBytesFor(count);
+}
+
+/**
+ * @brief Allocates the memory of one page of bytes bytes. With PageBytes_ it is exactly PageBytes_ bytes, aligned on
+ *  OS_PAGE_SIZE, so the page covers whole OS pages, and comes from the page cache if one is
+ *  attached and not empty. With IOAlignment_ it is aligned on at least IOAlignment_. The memory isn't zeroed,
+ *  the caller initialises it.
+ * 
+ * @param bytes Size of the page
+ * @return unsigned char* The memory
+ * @exception std::bad_alloc No memory
+ */
+unsigned char *ObjectAllocator::NewPageMemory(size_t bytes) const
+{
+    if (pageCache)
+        if (void *page = pageCache->Take())
+            return static_cast<unsigned char *>(page);
+    if (pageAlignment)
+        return static_cast<unsigned char *>(::operator new(configuration.PageBytes_ ? configuration.PageBytes_ : bytes + PTR_SIZE,
+                                                           std::align_val_t(pageAlignment)));
+    return new unsigned char[bytes + PTR_SIZE]; //not value-initialised, CreatePage fills it once
+}
+
+/**
+ * @brief Gives the memory of a page back to the system
+ * 
+ * @param page Page obtained from NewPageMemory
+ */
+void ObjectAllocator::DeletePageMemory(GenericObject *page) const
+{
+    if (pageAlignment)
+        ::operator delete(page, std::align_val_t(pageAlignment));
+    else
+        delete[] reinterpret_cast<unsigned char *>(page);
+}
+
+/**
+ * @brief Adaptive mode: doubles the size of the next page until the recent peak usage fits in
+ *  ADAPTIVE_TARGET_PAGES pages. Also notes churn, when released pages have to be created again.
+ * 
+ */
+void ObjectAllocator::AdaptOnNewPage()
+{
+    if (!configuration.AdaptivePages_)
+        return;
+    if (recentReleases)
+    {
+        churned = true;
+        recentReleases = 0;
+    }
+    unsigned count = configuration.ObjectsPerPage_;
+    unsigned wanted = count;
+    while (wanted < configuration.MaxObjectsPerPage_ && recentMostObjects > wanted * ADAPTIVE_TARGET_PAGES)
+        wanted *= 2;
+    if (wanted > configuration.MaxObjectsPerPage_)
+        wanted = configuration.MaxObjectsPerPage_;
+    if (wanted > count)
+    {
+        SetObjectsPerPage(wanted);
+        ++stats.PageGrowths_;
+    }
+}
+
+/**
+ * @brief Adaptive mode: halves the size of the next page after empty pages were released, while the
+ *  recent peak usage fits in a quarter of ADAPTIVE_TARGET_PAGES pages. The gap to the growth
+ *  threshold keeps the size from oscillating. While pages churn it shrinks one step at a time.
+ * 
+ * @param pagesFreed Number of pages just released
+ */
+void ObjectAllocator::AdaptOnRelease(unsigned pagesFreed)
+{
+    if (!configuration.AdaptivePages_ || !pagesFreed)
+        return;
+    unsigned count = configuration.ObjectsPerPage_;
+    unsigned wanted = count;
+    while (wanted / 2 >= configuration.MinObjectsPerPage_ && recentMostObjects * 4 <= wanted * ADAPTIVE_TARGET_PAGES)
+    {
+        wanted /= 2;
+        if (churned)
+            break;
+    }
+    if (wanted < count)
+    {
+        SetObjectsPerPage(wanted);
+        ++stats.PageShrinks_;
+    }
+    churned = false;
+    recentReleases += pagesFreed;
+    recentMostObjects = stats.ObjectsInUse_;
+}
+
+/**
+ * @brief Current time for lifetime tracking
+ * 
+ * @return unsigned long long Number of allocations so far, or cycle count, depending on Lifetimes_
+ */
+unsigned long long ObjectAllocator::Now() const
+{
+    if (configuration.Lifetimes_ == OAConfig::ltAllocations)
+        return stats.Allocations_;
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count()); //nanoseconds stand in for cycles
+#endif
+}
+
+/**
+ * @brief Constructs a new page, using the spare page if one was prepared in advance
  * 
- * @param page Previous page
  * @exception OAException E_NO_PAGES Throws an exception if the construction fails. (Memory allocation problem)
  * @exception OAException E_NO_MEMORY No memory
  */
-void ObjectAllocator::AllocateNewPage(GenericObject *&page)
+void ObjectAllocator::AllocateNewPage()
 {
-    if (stats.PagesInUse_ >= configuration.MaxPages_)
+    if (configuration.MaxPages_ && stats.PagesInUse_ >= configuration.MaxPages_) //0 means unlimited
         throw OAException(OAException::OA_EXCEPTION::E_NO_PAGES, "Exceeded max pages!");
     else
     {
+        AdaptOnNewPage();
+        bool unpaintedPage = !configuration.DebugOn_ && configuration.PadBytes_; //debugging may be switched on later
         // Allocate new page.
         GenericObject *newPage = nullptr;
         try
         {
-            newPage = reinterpret_cast<GenericObject *>(new unsigned char[stats.PageSize_ + PTR_SIZE]());
-            ++stats.PagesInUse_;
-            memset(newPage, 0, stats.PageSize_); //Avoid memory error
+            if (unpaintedPage && unpainted.size() == unpainted.capacity()) //room to record it before it exists
+                unpainted.reserve(unpainted.size() * 2 + 4);
+            newPage = TakeSparePage();
+            if (!newPage)
+            {
+                UpdatePageTemplate();
+                newPage = CreatePage(configuration.ObjectsPerPage_, configuration.DebugOn_);
+            }
         }
         catch (std::bad_alloc &exception)
         {
             throw OAException(OAException::OA_EXCEPTION::E_NO_MEMORY, "Out of memory!");
         }
+        LinkPage(newPage);
+        if (unpaintedPage)
+            unpainted.push_back(UnpaintedPage{newPage, PageObjects(newPage), std::vector<bool>()});
+    }
+}
 
-        if (configuration.DebugOn_)
-        {
-            memset(newPage, ALIGN_PATTERN, stats.PageSize_); //Initialise everything as alignment first
-        }
-        newPage->Next = page; //newPage next points to the prev page (newPage is now at the front)
-        PageList_ = newPage;  //update pageList
+/**
+ * @brief Allocates and initialises a page. Its blocks are already linked together, last block first,
+ *  the way AddToFreeList would have pushed them. The page is filled exactly once: zeroed, or for a
+ *  debug page copied from the page template when it has the template's object count (painted
+ *  otherwise), then only its links are written. Only reads the layout and the template, so the
+ *  provisioner thread may call it.
+ * 
+ * @param objects Number of blocks on the page
+ * @param debug Paint the debug signatures
+ * @return GenericObject* The page, not on the page list yet
+ * @exception std::bad_alloc No memory
+ */
+GenericObject *ObjectAllocator::CreatePage(unsigned objects, bool debug) const
+{
+    size_t pageSize = PageBytesFor(objects);
+    unsigned char *memory = NewPageMemory(pageSize);
+    if (!debug)
+        memset(memory, 0, pageSize); //the only fill, headers and tags are zeros too
+    else if (pageTemplate && objects == templateObjects)
+        memcpy(memory, pageTemplate, pageSize);
+    else
+        PaintPage(memory, objects);
 
-        unsigned char *pageStartAddress = reinterpret_cast<unsigned char *>(newPage);
-        //memset(pageStartAddress + PTR_SIZE, ALIGN_PATTERN, configuration.LeftAlignSize_);//after pointer
-        unsigned char *dataStartAddress = pageStartAddress + pageHeader; //Start of the DATA
+    GenericObject *newPage = reinterpret_cast<GenericObject *>(memory);
+    newPage->Next = nullptr;
+    if (pageInfoSize)
+        *reinterpret_cast<unsigned *>(memory + PTR_SIZE) = objects;
 
-        // For each start of the data...
-        for (; static_cast<unsigned int>(dataStartAddress - pageStartAddress) < stats.PageSize_; //Loop until the whole page is initialised
-             dataStartAddress += dataSize)
-        {
+    unsigned char *dataStartAddress = memory + pageHeader; //Start of the DATA
+    GenericObject *previous = nullptr;
+    for (unsigned i = 0; i < objects; ++i, dataStartAddress += dataSize)
+    {
+        GenericObject *dataAddress = reinterpret_cast<GenericObject *>(dataStartAddress);
+        dataAddress->Next = previous; // Chain to the previous block
+        if (checksums)
+            SealBlock(dataAddress, true);
+        previous = dataAddress;
+    }
+    return newPage;
+}
+
+/**
+ * @brief Writes the debug signatures of an empty page: alignment bytes, zeroed headers and tags,
+ *  pads and unallocated blocks. Leaves the links for CreatePage.
+ * 
+ * @param page Page memory, PageBytesFor(objects) bytes
+ * @param objects Number of blocks on the page
+ */
+void ObjectAllocator::PaintPage(unsigned char *page, unsigned objects) const
+{
+    memset(page, ALIGN_PATTERN, PageBytesFor(objects)); //Initialise everything as alignment first
 
-            GenericObject *dataAddress = reinterpret_cast<GenericObject *>(dataStartAddress); //Casting each data block to GenericObject *
-            //TODO initialize the actual header block to zeros when you create a page (faq)
-            unsigned char *headerStart = reinterpret_cast<unsigned char *>(dataAddress) - configuration.PadBytes_ - configuration.HBlockInfo_.size_; //before padding block
-            memset(headerStart, 0, configuration.HBlockInfo_.size_);
+    unsigned char *dataStartAddress = page + pageHeader; //Start of the DATA
+    // For each start of the data...
+    for (unsigned i = 0; i < objects; ++i, dataStartAddress += dataSize)
+    {
+        unsigned char *headerStart = HeaderStart(dataStartAddress); //before padding block
+        memset(headerStart, 0, configuration.HBlockInfo_.size_);
+        if (tagSize)
+            memset(TagOf(dataStartAddress), 0, tagSize);
 
-            //std::cout << "TEST!\n";
-            AddToFreeList(dataAddress); // Put to free list.
-            if (this->configuration.DebugOn_)
-            {
-                // Update padding sig
-                memset(reinterpret_cast<unsigned char *>(dataAddress) + PTR_SIZE, UNALLOCATED_PATTERN, stats.ObjectSize_ - PTR_SIZE);
-                memset(reinterpret_cast<unsigned char *>(dataAddress) - configuration.PadBytes_, PAD_PATTERN, configuration.PadBytes_);
-                memset(reinterpret_cast<unsigned char *>(dataAddress) + stats.ObjectSize_, PAD_PATTERN, configuration.PadBytes_);
-            }
+        // Update padding sig
+        memset(dataStartAddress + PTR_SIZE, UNALLOCATED_PATTERN, stats.ObjectSize_ - PTR_SIZE);
+        memset(dataStartAddress - configuration.PadBytes_, PAD_PATTERN, configuration.PadBytes_);
+        memset(dataStartAddress + stats.ObjectSize_, PAD_PATTERN, configuration.PadBytes_);
+    }
+}
+
+/**
+ * @brief Paints the page template for the current ObjectsPerPage_ if debug pages of that size have
+ *  no template yet. The provisioner is cancelled first, it may be copying the old template.
+ * 
+ * @exception std::bad_alloc No memory
+ */
+void ObjectAllocator::UpdatePageTemplate()
+{
+    if (!configuration.DebugOn_ || (pageTemplate && templateObjects == configuration.ObjectsPerPage_))
+        return;
+    if (provisioner)
+        provisioner->Cancel(this);
+    delete[] pageTemplate;
+    pageTemplate = nullptr;
+    pageTemplate = new unsigned char[stats.PageSize_];
+    PaintPage(pageTemplate, configuration.ObjectsPerPage_);
+    templateObjects = configuration.ObjectsPerPage_;
+}
+
+/**
+ * @brief Puts a page from CreatePage at the front of the page list and its blocks at the front of the
+ *  free list. O(1), the blocks are already chained.
+ * 
+ * @param page Page to add
+ */
+void ObjectAllocator::LinkPage(GenericObject *page)
+{
+    unsigned objects = PageObjects(page);
+    GenericObject *first = reinterpret_cast<GenericObject *>(reinterpret_cast<unsigned char *>(page) + pageHeader);
+    GenericObject *last = reinterpret_cast<GenericObject *>(reinterpret_cast<unsigned char *>(first) + dataSize * (objects - 1));
+    first->Next = FreeList_;
+    if (checksums)
+        SealBlock(first, true);
+    FreeList_ = last;
+    stats.FreeObjects_ += objects;
+
+    page->Next = PageList_; //newPage next points to the prev page (newPage is now at the front)
+    PageList_ = page;       //update pageList
+    ++stats.PagesInUse_;
+    if (poisoning) //every block is free, only the page's own header stays accessible
+        OAPoisonRegion(reinterpret_cast<unsigned char *>(page) + PTR_SIZE + pageInfoSize, PageBytes(page) - PTR_SIZE - pageInfoSize);
+}
+
+/**
+ * @brief Takes the page prepared in advance, if there is one and it was painted for the current
+ *  debug state
+ * 
+ * @return GenericObject* The spare page, or null
+ */
+GenericObject *ObjectAllocator::TakeSparePage()
+{
+    GenericObject *spare = sparePage.exchange(nullptr, std::memory_order_acquire);
+    if (spare && spareDebug != configuration.DebugOn_)
+    {
+        DeletePageMemory(spare);
+        spare = nullptr;
+    }
+    return spare;
+}
+
+/**
+ * @brief Asks the provisioner for a spare page, unless one is ready or being prepared, or it
+ *  couldn't be linked anyway because of MaxPages_
+ * 
+ */
+void ObjectAllocator::RequestSparePage()
+{
+    if (!provisioner || sparePending.load(std::memory_order_acquire) || sparePage.load(std::memory_order_relaxed))
+        return;
+    if (configuration.MaxPages_ && stats.PagesInUse_ >= configuration.MaxPages_)
+        return;
+    try
+    {
+        UpdatePageTemplate(); //the worker only reads it
+    }
+    catch (std::bad_alloc &)
+    {
+        return;
+    }
+    spareObjects = configuration.ObjectsPerPage_;
+    spareDebug = configuration.DebugOn_;
+    sparePending.store(true, std::memory_order_relaxed);
+    provisioner->Request(this);
+}
+
+/**
+ * @brief Prepares the requested spare page, on the provisioner thread. Out of memory only means
+ *  there is no spare page, the next AllocateNewPage reports it.
+ * 
+ */
+void ObjectAllocator::ProvisionSparePage()
+{
+    GenericObject *page = nullptr;
+    try
+    {
+        page = CreatePage(spareObjects, spareDebug);
+    }
+    catch (std::bad_alloc &)
+    {
+    }
+    sparePage.store(page, std::memory_order_release);
+    sparePending.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Prepares the spare page on the calling thread, for clients without a provisioner that would
+ *  rather build the next page at a quiet moment than inside Allocate
+ * 
+ * @return true A spare page was prepared
+ * @return false Not needed (enough free objects, spare already there, MaxPages_ reached) or no memory
+ */
+bool ObjectAllocator::PrepareSparePage()
+{
+    if (configuration.UseCPPMemManager_ || stats.FreeObjects_ >= configuration.ProvisionWatermark_)
+        return false;
+    if (sparePending.load(std::memory_order_acquire) || sparePage.load(std::memory_order_relaxed))
+        return false;
+    if (configuration.MaxPages_ && stats.PagesInUse_ >= configuration.MaxPages_)
+        return false;
+    try
+    {
+        UpdatePageTemplate();
+        sparePage.store(CreatePage(configuration.ObjectsPerPage_, configuration.DebugOn_), std::memory_order_relaxed);
+    }
+    catch (std::bad_alloc &)
+    {
+        return false;
+    }
+    spareDebug = configuration.DebugOn_;
+    return true;
+}
+
+/**
+ * @brief Allocates pages until there is a free object. When a page can't be allocated, the OOM
+ *  handler gets a chance to make room (free objects, release pages, raise MaxPages_) before
+ *  the exception reaches the client.
+ * 
+ * @exception OAException E_NO_PAGES Max pages reached and the handler didn't ask for a retry
+ * @exception OAException E_NO_MEMORY No memory and the handler didn't ask for a retry
+ */
+void ObjectAllocator::RefillFreeList()
+{
+    while (!FreeList_) //the handler may have freed objects of this pool, check before growing again
+    {
+        try
+        {
+            AllocateNewPage();
+        }
+        catch (OAException &e)
+        {
+            if (!HandleOOM(e.code()))
+                throw;
         }
     }
 }
 
+/**
+ * @brief Calls the OOM handler, unless there is none or it is already running
+ * 
+ * @param code The error about to be thrown
+ * @return true The handler asked for a retry
+ * @return false The error must be thrown
+ */
+bool ObjectAllocator::HandleOOM(OAException::OA_EXCEPTION code)
+{
+    if (!oomHandler || inOOMHandler)
+        return false;
+    inOOMHandler = true;
+    bool retry = false;
+    try
+    {
+        retry = oomHandler(*this, code);
+    }
+    catch (...)
+    {
+        inOOMHandler = false;
+        throw;
+    }
+    inOOMHandler = false;
+    return retry;
+}
+
 /**
  * @brief Adds obj to front of freelist
  * 
@@ -130,6 +830,8 @@ void ObjectAllocator::AddToFreeList(GenericObject *obj)
     GenericObject *temp = FreeList_;
     FreeList_ = obj;
     obj->Next = temp;
+    if (checksums) //FreeBlock verified the metadata and zeroed it, only the link is new
+        TagOf(obj)->checksum_ = freeMetadata ? ZeroedFreeChecksum(temp) : BlockChecksum(obj, true);
     stats.FreeObjects_++;
 }
 
@@ -139,36 +841,63 @@ void ObjectAllocator::AddToFreeList(GenericObject *obj)
  * @param label Label for external header if required
  * @return void* Pointer to memory for client
  * @exception OAException E_NO_MEMORY No memory
+ * @exception OAException E_CORRUPTED_BLOCK The next free block failed its checksum (Checksums_)
  */
 void *ObjectAllocator::Allocate(const char *label)
 {
     //std::cout << stats.Allocations_ << std::endl;
     if (configuration.UseCPPMemManager_) //Use new
+    {
+        unsigned char *newObj = nullptr;
+        while (!newObj)
+        {
+            try
+            {
+                newObj = configuration.IOAlignment_
+                    ? static_cast<unsigned char *>(::operator new(stats.ObjectSize_, std::align_val_t(configuration.IOAlignment_)))
+                    : new unsigned char[stats.ObjectSize_];
+            }
+            catch (std::bad_alloc &)
+            {
+                if (!HandleOOM(OAException::E_NO_MEMORY))
+                    throw OAException(OAException::E_NO_MEMORY, "Out of memory!");
+            }
+        }
+        ++stats.ObjectsInUse_;
+        if (stats.ObjectsInUse_ > stats.MostObjects_)
+            stats.MostObjects_ = stats.ObjectsInUse_;
+        ++stats.Allocations_;
+        --stats.FreeObjects_;
+        if (profiler && profiler->ShouldSample(stats.ObjectSize_))
+            profiler->RecordAllocation(newObj, stats.ObjectSize_); //drops the sample rather than throw
+        return reinterpret_cast<void *>(newObj);
+    }
+
+    //Use our allocator with pages
+    unsigned labelId = labels ? labels->Intern(label) : LabelTable::NO_LABEL; //may throw, so before a block is taken
+    if (lifetimes)
     {
         try
         {
-            unsigned char *newObj = new unsigned char[stats.ObjectSize_];
-            ++stats.ObjectsInUse_;
-            if (stats.ObjectsInUse_ > stats.MostObjects_)
-                stats.MostObjects_ = stats.ObjectsInUse_;
-            ++stats.Allocations_;
-            --stats.FreeObjects_;
-            return reinterpret_cast<void *>(newObj);
+            lifetimes->Reserve(labelId); //so Free never has to allocate
         }
         catch (std::bad_alloc &)
         {
-            throw OAException(OAException::E_NO_MEMORY, "Out of memory!");
+            throw OAException(OAException::E_NO_MEMORY, "Lifetimes: No memory available.");
         }
     }
-
-    //Use our allocator with pages
     if (!FreeList_) //If ran out of free space/nullptr
-    {
-
-        AllocateNewPage(PageList_);
-    }
+        RefillFreeList();
 
     void *startAddressOfObject = FreeList_; // Give address of available free space.
+    if (poisoning)
+        OpenBlock(startAddressOfObject);
+    if (checksums && TagOf(startAddressOfObject)->checksum_ != FreeChecksum(startAddressOfObject))
+    {
+        if (poisoning)
+            CloseBlock(startAddressOfObject, false);
+        throw OAException(OAException::E_CORRUPTED_BLOCK, "FREE BLOCK CHECKSUM FAILED: CORRUPTED BLOCK");
+    }
     FreeList_ = FreeList_->Next;            //Update next available space
 
     if (configuration.DebugOn_)
@@ -179,13 +908,17 @@ void *ObjectAllocator::Allocate(const char *label)
     ++stats.ObjectsInUse_;
     ++stats.Allocations_;
     --stats.FreeObjects_;
+    if (stats.FreeObjects_ < configuration.ProvisionWatermark_) //running low, get the next page ready
+        RequestSparePage();
     if (stats.ObjectsInUse_ > stats.MostObjects_)
         stats.MostObjects_ = stats.ObjectsInUse_;
+    if (stats.ObjectsInUse_ > recentMostObjects)
+        recentMostObjects = stats.ObjectsInUse_;
 
     //Update header blocks to client
     if (configuration.HBlockInfo_.type_ != OAConfig::HBLOCK_TYPE::hbNone)
     {
-        unsigned char *headerStart = reinterpret_cast<unsigned char *>(startAddressOfObject) - configuration.PadBytes_ - configuration.HBlockInfo_.size_; //before padding block
+        unsigned char *headerStart = HeaderStart(startAddressOfObject); //before padding block
         if (configuration.HBlockInfo_.type_ == OAConfig::HBLOCK_TYPE::hbBasic)
         {
             unsigned int *allocationNumber = reinterpret_cast<unsigned int *>(headerStart);
@@ -217,80 +950,277 @@ void *ObjectAllocator::Allocate(const char *label)
         }
     }
 
-    return startAddressOfObject;
+    if (labels) //Account the block to its label
+    {
+        TagOf(startAddressOfObject)->label_ = labelId;
+        labels->OnAllocate(labelId, stats.ObjectSize_);
+    }
+    if (lifetimes)
+        TagOf(startAddressOfObject)->birth_ = Now();
+
+    if (profiler && profiler->ShouldSample(stats.ObjectSize_))
+        profiler->RecordAllocation(startAddressOfObject, stats.ObjectSize_); //drops the sample rather than throw
+    if (checksums)
+        SealBlock(startAddressOfObject, false);
+    if (poisoning)
+        CloseBlock(startAddressOfObject, true);
+
+    return startAddressOfObject;
+}
+
+/**
+ * @brief Destroy the Object Allocator, frees up memory
+ * 
+ */
+ObjectAllocator::~ObjectAllocator()
+{
+    if (provisioner)
+        provisioner->Cancel(this); //make sure no spare page is being prepared for us
+    GenericObject *spare = sparePage.exchange(nullptr);
+    if (spare)
+        DeletePageMemory(spare);
+    OpenPages();
+
+    GenericObject *page = PageList_; //first page
+    while (page != nullptr)          //loop through all pages
+    {
+        GenericObject *nextPage = page->Next;
+        unsigned char *obj = reinterpret_cast<unsigned char *>(page) + pageHeader;
+
+        if (configuration.HBlockInfo_.type_ == OAConfig::hbExternal) //free any active external header in case Free() was not called when page is deleted
+        {
+
+            unsigned char *headerStart = HeaderStart(obj);
+            MemBlockInfo **externalHeader = reinterpret_cast<MemBlockInfo **>(headerStart);
+            if (externalHeader)
+            {
+                delete *externalHeader; //label will be freed in destructor
+                *externalHeader = nullptr;
+                externalHeader = nullptr;
+            }
+        }
+        if (!pageCache || !pageCache->Put(page))
+            DeletePageMemory(page); //delete whole page
+        page = nextPage;
+    }
+    delete labels;
+    delete lifetimes;
+    delete[] pageTemplate;
+}
+
+/**
+ * @brief Constructor for external header block
+ * 
+ * @param use Bool to indicate whether the header block is used
+ * @param str Name of the null terminated string to be stored in the external header if any
+ * @param allocs Allocation count of this block
+ * @exception OAException E_NO_MEMORY No memory
+ */
+MemBlockInfo::MemBlockInfo(bool use, const char *str, unsigned allocs)
+    : in_use{use}, label{nullptr}, alloc_num{allocs}
+{
+    if (str != nullptr)
+    {
+        try
+        {
+            label = new char[strlen(str) + 1](); //Allocate mem to store the string
+            strcpy(label, str);
+        }
+        catch (std::bad_alloc &e)
+        {
+            throw(OAException(OAException::E_NO_MEMORY, "MemBlock Label: No memory available."));
+        }
+    }
+}
+
+/**
+ * @brief Destroy the MemBlockInfo block and free any dynamic memory
+ * 
+ */
+MemBlockInfo::~MemBlockInfo()
+{
+    delete[] label;
+}
+
+/**
+ * @brief Sets DebugState. Switching debugging on paints the free blocks right away; the pads of the
+ *  blocks in use on pages made while it was off are painted when they are freed, and aren't checked
+ *  until then. Switching it off wipes the FREED_PATTERN of the free blocks, which would make them
+ *  look freed again if they are allocated while it is off and freed after it is back on.
+ * 
+ * @param State Boolean, to use debugState or not
+ * @exception OAException E_NO_MEMORY No memory to track the unpainted blocks
+ */
+void ObjectAllocator::SetDebugState(bool State)
+{
+    if (State != configuration.DebugOn_ && !configuration.UseCPPMemManager_)
+    {
+        if (State)
+            PaintFreeBlocks();
+        else if (stats.ObjectSize_ > PTR_SIZE)
+        {
+            OpenPages();
+            for (GenericObject *block = FreeList_; block; block = block->Next)
+                reinterpret_cast<unsigned char *>(block)[PTR_SIZE] = 0; //the byte FreeBlock looks at
+            ClosePages();
+        }
+    }
+    configuration.DebugOn_ = State;
+}
+
+/**
+ * @brief Called when debugging is switched on. Sorts the pages made while it was off and gives each a
+ *  map of its painted blocks, then writes the signatures of every free block: FREED_PATTERN in the
+ *  data, so freeing it again is caught, and the pads if its page is unpainted. Nothing is paid for
+ *  this while debugging stays off.
+ * 
+ * @exception OAException E_NO_MEMORY No memory for the maps
+ */
+void ObjectAllocator::PaintFreeBlocks()
+{
+    try
+    {
+        std::sort(unpainted.begin(), unpainted.end(), [](const UnpaintedPage &a, const UnpaintedPage &b) { return a.page_ < b.page_; });
+        for (UnpaintedPage &page : unpainted)
+            if (page.painted_.empty())
+                page.painted_.assign(page.remaining_, false);
+    }
+    catch (std::bad_alloc &)
+    {
+        throw OAException(OAException::E_NO_MEMORY, "Out of memory!");
+    }
+
+    OpenPages();
+    for (GenericObject *block = FreeList_; block; block = block->Next)
+    {
+        unsigned char *obj = reinterpret_cast<unsigned char *>(block);
+        if (!unpainted.empty())
+            RepaintBlock(obj);
+        memset(obj + PTR_SIZE, FREED_PATTERN, stats.ObjectSize_ - PTR_SIZE);
+    }
+    ClosePages();
+}
+
+/**
+ * @brief Finds the unpainted page holding an address (unpainted must be sorted)
+ * 
+ * @param obj Address to look for
+ * @return size_t Index of the page in unpainted, unpainted.size() if obj isn't on an unpainted page
+ */
+size_t ObjectAllocator::FindUnpainted(const void *obj) const
+{
+    std::vector<UnpaintedPage>::const_iterator it = std::upper_bound(unpainted.begin(), unpainted.end(), obj,
+        [](const void *address, const UnpaintedPage &page) { return address < static_cast<const void *>(page.page_); });
+    if (it == unpainted.begin() || !IsOnPage(obj, (it - 1)->page_))
+        return unpainted.size();
+    return static_cast<size_t>(it - 1 - unpainted.begin());
+}
+
+/**
+ * @brief Paints the pads of a block of an unpainted page, the first time it is freed with debugging
+ *  on. A page is forgotten once all its blocks are painted.
+ * 
+ * @param obj Block being freed
+ * @return true The pads were just painted, there was nothing to check
+ * @return false The pads were already painted (or obj isn't a block), CheckPadding applies
+ */
+bool ObjectAllocator::RepaintBlock(unsigned char *obj)
+{
+    size_t index = FindUnpainted(obj);
+    if (index == unpainted.size())
+        return false;
+    UnpaintedPage &page = unpainted[index];
+    unsigned char *first = reinterpret_cast<unsigned char *>(page.page_) + pageHeader;
+    if (obj < first || (obj - first) % dataSize)
+        return false;
+    size_t block = static_cast<size_t>(obj - first) / dataSize;
+    if (page.painted_[block])
+        return false;
+
+    memset(obj - configuration.PadBytes_, PAD_PATTERN, configuration.PadBytes_);
+    memset(obj + stats.ObjectSize_, PAD_PATTERN, configuration.PadBytes_);
+    page.painted_[block] = true;
+    if (--page.remaining_ == 0)
+        unpainted.erase(unpainted.begin() + static_cast<std::ptrdiff_t>(index));
+    return true;
 }
 
 /**
- * @brief Destroy the Object Allocator, frees up memory
+ * @brief Attaches a sampling heap profiler to the allocator
  * 
+ * @param Profiler Profiler to feed (not owned, must outlive the allocator), null to detach
  */
-ObjectAllocator::~ObjectAllocator()
+void ObjectAllocator::SetProfiler(HeapProfiler *Profiler)
 {
-    GenericObject *page = PageList_; //first page
-    while (page != nullptr)          //loop through all pages
-    {
-        GenericObject *nextPage = page->Next;
-        unsigned char *obj = reinterpret_cast<unsigned char *>(page) + pageHeader;
+    profiler = Profiler;
+}
 
-        if (configuration.HBlockInfo_.type_ == OAConfig::hbExternal) //free any active external header in case Free() was not called when page is deleted
-        {
+/**
+ * @brief Installs the handler called when the pool can't grow. Like a std::new_handler, it must either
+ *  make room and return true (the allocation is retried), or return false (the exception is thrown).
+ *  A handler that keeps returning true without making room loops forever.
+ * 
+ * @param Handler The new handler, null to remove it
+ * @return OOMHANDLER The previous handler
+ */
+ObjectAllocator::OOMHANDLER ObjectAllocator::SetOOMHandler(OOMHANDLER Handler)
+{
+    OOMHANDLER previous = oomHandler;
+    oomHandler = Handler;
+    return previous;
+}
 
-            unsigned char *headerStart = reinterpret_cast<unsigned char *>(obj) - configuration.PadBytes_ - configuration.HBlockInfo_.size_;
-            MemBlockInfo **externalHeader = reinterpret_cast<MemBlockInfo **>(headerStart);
-            if (externalHeader)
-            {
-                delete *externalHeader; //label will be freed in destructor
-                *externalHeader = nullptr;
-                externalHeader = nullptr;
-            }
-        }
-        delete[] reinterpret_cast<unsigned char *>(page); //delete whole page
-        page = nextPage;
-    }
+/**
+ * @brief Changes the maximum number of pages. Lowering it below PagesInUse_ frees nothing, it only
+ *  stops the pool from growing.
+ * 
+ * @param MaxPages New limit (0=unlimited)
+ */
+void ObjectAllocator::SetMaxPages(unsigned MaxPages)
+{
+    configuration.MaxPages_ = MaxPages;
 }
 
 /**
- * @brief Constructor for external header block
+ * @brief Attaches the background thread that prepares the next page when fewer than
+ *  ProvisionWatermark_ objects are free
  * 
- * @param use Bool to indicate whether the header block is used
- * @param str Name of the null terminated string to be stored in the external header if any
- * @param allocs Allocation count of this block
- * @exception OAException E_NO_MEMORY No memory
+ * @param Provisioner Provisioner to use (not owned, must outlive the allocator), null to detach
  */
-MemBlockInfo::MemBlockInfo(bool use, const char *str, unsigned allocs)
-    : in_use{use}, label{nullptr}, alloc_num{allocs}
+void ObjectAllocator::SetProvisioner(PageProvisioner *Provisioner)
 {
-    if (str != nullptr)
-    {
-        try
-        {
-            label = new char[strlen(str) + 1](); //Allocate mem to store the string
-            strcpy(label, str);
-        }
-        catch (std::bad_alloc &e)
-        {
-            throw(OAException(OAException::E_NO_MEMORY, "MemBlock Label: No memory available."));
-        }
-    }
+    if (provisioner)
+        provisioner->Cancel(this);
+    provisioner = Provisioner;
 }
 
 /**
- * @brief Destroy the MemBlockInfo block and free any dynamic memory
+ * @brief Attaches the background thread that deletes the pages released by FreeEmptyPages
  * 
+ * @param Reclaimer Reclaimer to use (not owned, must outlive the pages handed to it), null to delete pages right away
  */
-MemBlockInfo::~MemBlockInfo()
+void ObjectAllocator::SetReclaimer(PageReclaimer *Reclaimer)
 {
-    delete[] label;
+    reclaimer = Reclaimer;
 }
 
 /**
- * @brief Sets DebugState
+ * @brief Shares a cache of empty pages with the other allocators attached to it. New pages are taken
+ *  from the cache before the system, and the pages released by FreeEmptyPages or the destructor go
+ *  back to it, whatever object size they were formatted for. Only allocators with OAConfig::PageBytes_
+ *  equal to the cache's page size (and pages aligned the same, so no IOAlignment_ above it) can use it.
  * 
- * @param State Boolean, to use debugState or not
+ * @param Cache Cache to use (not owned, must outlive the allocator), null to detach
+ * @return true The allocator uses Cache
+ * @return false Its pages don't fit Cache, the allocator uses no cache
  */
-void ObjectAllocator::SetDebugState(bool State)
+bool ObjectAllocator::SetPageCache(PageCache *Cache)
 {
-    configuration.DebugOn_ = State;
+    if (provisioner)
+        provisioner->Cancel(this); //it may be taking a page from the old cache
+    bool fits = Cache && Cache->PageBytes() == configuration.PageBytes_ && Cache->Alignment() == pageAlignment;
+    pageCache = fits ? Cache : nullptr;
+    return fits || !Cache;
 }
 
 /**
@@ -348,24 +1278,112 @@ void ObjectAllocator::Free(void *obj)
     --stats.ObjectsInUse_;
     if (configuration.UseCPPMemManager_)
     {
-        delete[] reinterpret_cast<unsigned char *>(obj);
-        return;
+        if (configuration.IOAlignment_)
+            ::operator delete(obj, std::align_val_t(configuration.IOAlignment_));
+        else
+            delete[] reinterpret_cast<unsigned char *>(obj);
     }
+    else if (poisoning)
+    {
+        if (OAIsPoisoned(obj)) //free blocks are poisoned
+            throw OAException(OAException::E_MULTIPLE_FREE, "Multiple free!");
+        CheckPageBoundary(reinterpret_cast<unsigned char *>(obj)); //never unpoison memory outside the pages
+        OpenBlock(obj);
+        try
+        {
+            FreeBlock(obj);
+        }
+        catch (OAException &e)
+        {
+            CloseBlock(obj, e.code() != OAException::E_MULTIPLE_FREE);
+            throw;
+        }
+        CloseBlock(obj, false);
+    }
+    else
+        FreeBlock(obj);
+    if (profiler) //only once obj turned out to be a live block
+        profiler->RecordFree(obj);
+}
+
+/**
+ * @brief Allocates count blocks and describes them in iov, ready for readv/writev/preadv2. Either all the
+ *  blocks are allocated or, if one fails, the ones already taken are freed and the exception is passed on.
+ * 
+ * @param count Number of blocks
+ * @param iov Array of at least count entries, each gets a block and the object size
+ * @param label Label passed to Allocate
+ * @exception OAException E_NO_MEMORY, E_NO_PAGES Same as Allocate
+ */
+void ObjectAllocator::AllocateIov(unsigned count, struct iovec *iov, const char *label)
+{
+    unsigned i = 0;
+    try
+    {
+        for (; i < count; ++i)
+        {
+            iov[i].iov_base = Allocate(label);
+            iov[i].iov_len = stats.ObjectSize_;
+        }
+    }
+    catch (OAException &)
+    {
+        while (i)
+            Free(iov[--i].iov_base);
+        throw;
+    }
+}
+
+/**
+ * @brief Frees the blocks of an iovec array filled by AllocateIov
+ * 
+ * @param count Number of blocks
+ * @param iov The blocks, iov_len is ignored
+ * @exception OAException Same as Free
+ */
+void ObjectAllocator::FreeIov(unsigned count, const struct iovec *iov)
+{
+    for (unsigned i = 0; i < count; ++i)
+        Free(iov[i].iov_base);
+}
+
+/**
+ * @brief Checks a block given to Free and puts it back on the free list
+ * 
+ * @param obj Object to be freed
+ * @exception OAException E_BAD_BOUNDARY, E_CORRUPTED_BLOCK, E_MULTIPLE_FREE Debug or checksum checks failed
+ */
+void ObjectAllocator::FreeBlock(void *obj)
+{
     if (configuration.DebugOn_)
     {
         CheckPageBoundary(reinterpret_cast<unsigned char *>(obj)); //check if obj is within pages
-        CheckPadding(reinterpret_cast<unsigned char *>(obj));      //check for memory overruns and underruns.
+        if (unpainted.empty() || !RepaintBlock(reinterpret_cast<unsigned char *>(obj))) //pads painted only now have nothing to check
+            CheckPadding(reinterpret_cast<unsigned char *>(obj));  //check for memory overruns and underruns.
         //check for double free
         if (*(reinterpret_cast<unsigned char *>(obj) + PTR_SIZE) == FREED_PATTERN) //reason for + PTR_SIZE, in AddToFreeList(), i replaced the FREED_PATTERN ENUM with pointer data
         {
             throw OAException(OAException::E_MULTIPLE_FREE, "Multiple free!");
         }
+    }
+    if (checksums) //catches double frees and overwritten headers without debugging too
+    {
+        unsigned checksum = TagOf(obj)->checksum_;
+        if (checksum != BlockChecksum(obj, false))
+        {
+            if (checksum == FreeChecksum(obj))
+                throw OAException(OAException::E_MULTIPLE_FREE, "Multiple free!");
+            throw OAException(OAException::E_CORRUPTED_BLOCK, "CHECKSUM FAILED: CORRUPTED BLOCK");
+        }
+    }
+    if (configuration.DebugOn_)
+    {
         memset(reinterpret_cast<GenericObject *>(obj), FREED_PATTERN, stats.ObjectSize_); //Set the table as freed if no issues
     }
     if (configuration.HBlockInfo_.type_ != OAConfig::HBLOCK_TYPE::hbNone)
     {
         //free headers
-        unsigned char *headerStart = reinterpret_cast<unsigned char *>(obj) - configuration.PadBytes_ - configuration.HBlockInfo_.size_;
+        unsigned char *headerStart = HeaderStart(obj);
         if (configuration.HBlockInfo_.type_ == OAConfig::HBLOCK_TYPE::hbBasic)
         {
             memset(headerStart, 0, OAConfig::BASIC_HEADER_SIZE); //Set basic block to 0
@@ -382,6 +1400,18 @@ void ObjectAllocator::Free(void *obj)
             externalHeader = nullptr;
         }
     }
+    if (lifetimes)
+    {
+        BlockTag *tag = TagOf(obj);
+        lifetimes->Add(tag->label_, labels ? labels->Name(tag->label_) : nullptr, tag->birth_, Now() - tag->birth_);
+        tag->birth_ = 0;
+    }
+    if (labels)
+    {
+        BlockTag *tag = TagOf(obj);
+        labels->OnFree(tag->label_, stats.ObjectSize_);
+        tag->label_ = LabelTable::NO_LABEL;
+    }
     AddToFreeList(reinterpret_cast<GenericObject *>(obj)); //add back to freelist
 }
 
@@ -396,7 +1426,7 @@ void ObjectAllocator::CheckPageBoundary(const unsigned char *obj)
     GenericObject *page = PageList_;
     while (page)
     {
-        if ((obj >= reinterpret_cast<unsigned char *>(page) && obj < reinterpret_cast<unsigned char *>(page) + stats.PageSize_))
+        if (IsOnPage(obj, page))
         {
             break; //within page
         }
@@ -453,10 +1483,12 @@ unsigned ObjectAllocator::DumpMemoryInUse(DUMPCALLBACK fn) const
 {
     GenericObject *page = PageList_;
     unsigned int leaks = 0;
+    OpenPages();
     while (page)
     {
         unsigned char *obj = reinterpret_cast<unsigned char *>(page) + pageHeader;
-        for (unsigned int i = 0; i < configuration.ObjectsPerPage_; ++i)
+        unsigned objects = PageObjects(page);
+        for (unsigned int i = 0; i < objects; ++i)
         {
             //unsigned char *headerStart = reinterpret_cast<unsigned char *>(obj) - configuration.PadBytes_ - configuration.HBlockInfo_.size_;
             if (configuration.HBlockInfo_.type_ == OAConfig::HBLOCK_TYPE::hbNone)
@@ -481,11 +1513,13 @@ unsigned ObjectAllocator::DumpMemoryInUse(DUMPCALLBACK fn) const
         }
         page = page->Next; //Next page
     }
+    ClosePages();
     return leaks;
 }
 
 /**
- * @brief Calls the callback fn for each block that is corrupted
+ * @brief Calls the callback fn for each block that is corrupted: overwritten pads (debug mode) or
+ *  metadata that doesn't match its checksum (Checksums_)
  * 
  * @param fn Callback fn
  * @return unsigned Number of corrupted blocks
@@ -493,51 +1527,45 @@ unsigned ObjectAllocator::DumpMemoryInUse(DUMPCALLBACK fn) const
 unsigned ObjectAllocator::ValidatePages(VALIDATECALLBACK fn) const
 {
     unsigned int count = 0;
-    if (!configuration.DebugOn_ || configuration.PadBytes_ == 0)
+    bool pads = configuration.DebugOn_ && configuration.PadBytes_;
+    if (!pads && !checksums)
         return 0;
 
+    OpenPages();
     GenericObject *page = PageList_;
     while (page)
     {
         unsigned char *obj = reinterpret_cast<unsigned char *>(page) + pageHeader;
-        for (unsigned int i = 0; i < configuration.ObjectsPerPage_; ++i)
+        unsigned objects = PageObjects(page);
+        size_t unpaintedPage = unpainted.empty() ? 0 : FindUnpainted(page);
+        for (unsigned int i = 0; i < objects; ++i, obj += dataSize)
         {
-            const unsigned char *leftPadStart = reinterpret_cast<const unsigned char *>(obj) - configuration.PadBytes_;
-            const unsigned char *rightPadStart = reinterpret_cast<const unsigned char *>(obj) + stats.ObjectSize_;
-            for (unsigned int i = 0; i < configuration.PadBytes_; ++i)
+            bool corrupted = false;
+            if (pads && (unpaintedPage >= unpainted.size() || unpainted[unpaintedPage].painted_[i])) //pads painted
             {
-                if (*(leftPadStart + i) != PAD_PATTERN) //LEFT PAD CHECK
-                {
-                    count++;
-                    fn(obj, stats.ObjectSize_);
-                    break; //Stop checking the block, go to next object
-                }
-                else
-                {
-                    if (i == configuration.PadBytes_ - 1)
-                    {
-                        for (unsigned int j = 0; j < configuration.PadBytes_; ++j)
-                        {
-                            if (*(rightPadStart + j) != PAD_PATTERN) //RIGHT PAD CHECK
-                            {
-                                count++;
-                                fn(obj, stats.ObjectSize_);
-                                break; //Stop checking the block
-                            }
-                        }
-                    }
-                }
+                const unsigned char *leftPadStart = obj - configuration.PadBytes_;
+                const unsigned char *rightPadStart = obj + stats.ObjectSize_;
+                for (unsigned int j = 0; j < configuration.PadBytes_ && !corrupted; ++j)
+                    corrupted = leftPadStart[j] != PAD_PATTERN || rightPadStart[j] != PAD_PATTERN;
+            }
+            if (!corrupted && checksums)
+                corrupted = !ChecksumMatches(obj);
+            if (corrupted)
+            {
+                count++;
+                fn(obj, stats.ObjectSize_);
             }
-
-            obj += dataSize;
         }
         page = page->Next;
     }
+    ClosePages();
     return count;
 }
 
 /**
- * @brief This function frees all empty pages
+ * @brief This function frees all empty pages. Counts the free blocks of every page in one pass over
+ *  the free list (pages sorted by address), then unlinks the empty pages and their blocks in one pass
+ *  over each list, so it costs O((pages + free objects) log pages) instead of a free list walk per page.
  * 
  * @return unsigned Number of pages freed
  */
@@ -546,100 +1574,399 @@ unsigned ObjectAllocator::FreeEmptyPages()
     if (!PageList_)
         return 0;
 
-    GenericObject *page = PageList_, *prev = nullptr;
+    OpenPages();
+    std::vector<PageUsage> pages;
+    pages.reserve(stats.PagesInUse_);
+    for (GenericObject *page = PageList_; page; page = page->Next)
+        pages.push_back(PageUsage{page, 0, false});
+    std::sort(pages.begin(), pages.end(), [](const PageUsage &a, const PageUsage &b) { return a.page_ < b.page_; });
+
+    for (GenericObject *freeBlock = FreeList_; freeBlock; freeBlock = freeBlock->Next)
+        ++FindPage(pages, freeBlock)->free_;
+
     unsigned pagesFreed = 0;
-    while (page) //case if head node of pagelist contains empty page
+    for (PageUsage &usage : pages)
+    {
+        usage.empty_ = usage.free_ == PageObjects(usage.page_);
+        if (usage.empty_)
+            ++pagesFreed;
+    }
+    if (!pagesFreed)
+    {
+        ClosePages();
+        AdaptOnRelease(0);
+        return 0;
+    }
+
+    GenericObject **link = &FreeList_;
+    while (*link) //unlink the blocks of the empty pages, keeping the order of the others
     {
-        if (IsPageEmpty(page))
+        if (FindPage(pages, *link)->empty_)
         {
-            PageList_ = page->Next;
-            FreePage(page);
-            page = PageList_;
-            pagesFreed++;
+            *link = (*link)->Next;
+            --stats.FreeObjects_;
+            if (checksums && link != &FreeList_) //the link lives in the previous free block
+                SealBlock(link, true);
         }
         else
-            break;
+            link = &(*link)->Next;
     }
-    while (page) //every other node other than head node containing empty page
+
+    link = &PageList_;
+    while (*link)
     {
-        if (!IsPageEmpty(page))
+        GenericObject *page = *link;
+        if (FindPage(pages, page)->empty_)
         {
-            prev = page;
-            page = page->Next;
+            *link = page->Next;
+            ReleasePage(page);
         }
         else
-        {
-            prev->Next = page->Next;
-            FreePage(page);
-            page = prev->Next;
-            pagesFreed++;
-        }
+            link = &page->Next;
     }
+    if (!unpainted.empty()) //forget the released pages
+        unpainted.erase(std::remove_if(unpainted.begin(), unpainted.end(),
+                                       [&pages](const UnpaintedPage &unpaintedPage) { return FindPage(pages, unpaintedPage.page_)->empty_; }),
+                        unpainted.end());
+    ClosePages();
+    AdaptOnRelease(pagesFreed);
     return pagesFreed;
 }
 
 /**
- * @brief This function checks if every data block inside the page is empty
+ * @brief Finds the page holding an address
+ * 
+ * @param pages Pages sorted by address
+ * @param obj Address on one of the pages
+ * @return PageUsage* Entry of the page
+ */
+ObjectAllocator::PageUsage *ObjectAllocator::FindPage(std::vector<PageUsage> &pages, const void *obj)
+{
+    std::vector<PageUsage>::iterator it = std::upper_bound(pages.begin(), pages.end(), obj,
+        [](const void *address, const PageUsage &usage) { return address < static_cast<const void *>(usage.page_); });
+    return &*(it - 1); //last page starting at or before obj
+}
+
+/**
+ * @brief Gives the memory of an unlinked page back: to the page cache if there is one with room, where
+ *  any allocator can reformat it, otherwise through the reclaimer if there is one
+ * 
+ * @param page Page no longer on the page list, none of its blocks on the free list
+ */
+void ObjectAllocator::ReleasePage(GenericObject *page)
+{
+    if (!pageCache || !pageCache->Put(page))
+    {
+        if (reclaimer)
+            reclaimer->Release(page, pageAlignment); //the worker deletes it, we only paid for the unlink
+        else
+            DeletePageMemory(page);
+    }
+    stats.PagesInUse_--;
+}
+
+/**
+ * @brief Returns the usage of one label
+ * 
+ * @param label Label given to Allocate (null for unlabelled allocations)
+ * @return OALabelStats Usage of the label, all zeros if the label was never seen or TrackLabels_ is off
+ */
+OALabelStats ObjectAllocator::GetLabelStats(const char *label) const
+{
+    if (!labels)
+        return OALabelStats();
+    unsigned id = labels->Find(label);
+    if (id == LabelTable::NOT_FOUND)
+        return OALabelStats();
+    return labels->Stats(id);
+}
+
+/**
+ * @brief Calls the callback fn for each label seen so far (the unlabelled usage has a null label)
+ * 
+ * @param fn Callback function
+ * @return unsigned Number of labels reported
+ */
+unsigned ObjectAllocator::DumpLabelStats(LABELCALLBACK fn) const
+{
+    if (!labels)
+        return 0;
+    unsigned count = labels->Count();
+    for (unsigned id = 0; id < count; ++id)
+        fn(labels->Name(id), labels->Stats(id));
+    return count;
+}
+
+/**
+ * @brief Returns the lifetime histogram of every block freed so far
+ * 
+ * @return OALifetimeHistogram The histogram, empty if Lifetimes_ is off
+ */
+OALifetimeHistogram ObjectAllocator::GetLifetimeHistogram() const
+{
+    if (!lifetimes)
+        return OALifetimeHistogram();
+    return lifetimes->Overall();
+}
+
+/**
+ * @brief Returns the lifetime histogram of the blocks of one label (requires TrackLabels_ as well)
+ * 
+ * @param label Label given to Allocate (null for unlabelled allocations)
+ * @return OALifetimeHistogram The histogram, empty if the label was never seen
+ */
+OALifetimeHistogram ObjectAllocator::GetLifetimeHistogram(const char *label) const
+{
+    if (!lifetimes || !labels)
+        return OALifetimeHistogram();
+    unsigned id = labels->Find(label);
+    if (id == LabelTable::NOT_FOUND)
+        return OALifetimeHistogram();
+    return lifetimes->ByLabel(id);
+}
+
+/**
+ * @brief Copies the longest-lived freed blocks, longest first
+ * 
+ * @param out Array of at least count entries
+ * @param count Maximum number of entries to copy
+ * @return unsigned Number of entries copied
+ */
+unsigned ObjectAllocator::GetLongestLived(OALongLived *out, unsigned count) const
+{
+    if (!lifetimes)
+        return 0;
+    unsigned copied = 0;
+    for (const OALongLived &entry : lifetimes->Longest())
+    {
+        if (copied == count)
+            break;
+        out[copied++] = entry;
+    }
+    return copied;
+}
+
+/**
+ * @brief Tells whether a block is live and gives its allocation number, from its header or, without
+ *  a header, from its tag when Lifetimes_ counts allocations
+ * 
+ * @param obj Start of the client's data
+ * @param allocNum Allocation number of the block, set when it is live
+ * @return true The block is live
+ * @return false The block is free (or the configuration doesn't record allocation numbers)
+ */
+bool ObjectAllocator::LiveAllocNum(unsigned char *obj, unsigned &allocNum) const
+{
+    unsigned char *headerStart = HeaderStart(obj);
+    switch (configuration.HBlockInfo_.type_)
+    {
+    case OAConfig::HBLOCK_TYPE::hbBasic:
+        allocNum = *reinterpret_cast<unsigned int *>(headerStart);
+        return headerStart[sizeof(unsigned int)] != 0;
+    case OAConfig::HBLOCK_TYPE::hbExtended:
+        headerStart += configuration.HBlockInfo_.additional_ + sizeof(unsigned short); //skip user field and use count
+        allocNum = *reinterpret_cast<unsigned int *>(headerStart);
+        return headerStart[sizeof(unsigned int)] != 0;
+    case OAConfig::HBLOCK_TYPE::hbExternal:
+    {
+        MemBlockInfo *info = *reinterpret_cast<MemBlockInfo **>(headerStart);
+        if (!info)
+            return false;
+        allocNum = info->alloc_num;
+        return true;
+    }
+    default:
+        break;
+    }
+    if (configuration.Lifetimes_ != OAConfig::ltAllocations)
+        return false;
+    unsigned long long birth = TagOf(obj)->birth_;
+    allocNum = static_cast<unsigned>(birth);
+    return birth != 0;
+}
+
+/**
+ * @brief Poisoning: makes a block's tag, header, pads and data accessible to the allocator
+ * 
+ * @param obj Start of the client's data
+ */
+void ObjectAllocator::OpenBlock(void *obj) const
+{
+    size_t left = tagSize + configuration.HBlockInfo_.size_ + configuration.PadBytes_;
+    OAUnpoisonRegion(reinterpret_cast<unsigned char *>(obj) - left, left + stats.ObjectSize_ + configuration.PadBytes_);
+}
+
+/**
+ * @brief Poisoning: poisons what OpenBlock unpoisoned, leaving the data of a live block to the client
+ * 
+ * @param obj Start of the client's data
+ * @param live The block is allocated
+ */
+void ObjectAllocator::CloseBlock(void *obj, bool live) const
+{
+    size_t left = tagSize + configuration.HBlockInfo_.size_ + configuration.PadBytes_;
+    OAPoisonRegion(reinterpret_cast<unsigned char *>(obj) - left, left + stats.ObjectSize_ + configuration.PadBytes_);
+    if (live)
+        OAUnpoisonRegion(obj, stats.ObjectSize_);
+}
+
+/**
+ * @brief Poisoning: makes every page accessible, for the functions that walk all the blocks
+ * 
+ */
+void ObjectAllocator::OpenPages() const
+{
+    if (!poisoning)
+        return;
+    for (GenericObject *page = PageList_; page; page = page->Next)
+        OAUnpoisonRegion(page, PageBytes(page));
+}
+
+/**
+ * @brief Poisoning: poisons the pages again after OpenPages. The data of every block is unpoisoned,
+ *  then the free blocks are poisoned while walking the free list.
  * 
- * @param page Page to be checked
- * @return true Empty page
- * @return false Not empty
  */
-bool ObjectAllocator::IsPageEmpty(GenericObject *page)
+void ObjectAllocator::ClosePages() const
 {
+    if (!poisoning)
+        return;
+    for (GenericObject *page = PageList_; page; page = page->Next)
+    {
+        OAPoisonRegion(reinterpret_cast<unsigned char *>(page) + PTR_SIZE + pageInfoSize, PageBytes(page) - PTR_SIZE - pageInfoSize);
+        unsigned char *obj = reinterpret_cast<unsigned char *>(page) + pageHeader;
+        unsigned objects = PageObjects(page);
+        for (unsigned i = 0; i < objects; ++i, obj += dataSize)
+            OAUnpoisonRegion(obj, stats.ObjectSize_);
+    }
     GenericObject *freeBlock = FreeList_;
-    unsigned i = 0;
     while (freeBlock)
     {
-        if (reinterpret_cast<unsigned char *>(freeBlock) >= reinterpret_cast<unsigned char *>(page) && reinterpret_cast<unsigned char *>(freeBlock) < reinterpret_cast<unsigned char *>(page) + stats.PageSize_) //Check if freeBlock is within current page boundary
-        {
-            ++i;
-            if (i >= configuration.ObjectsPerPage_) //Whole page is empty
-                return true;
-        }
-        freeBlock = freeBlock->Next; //Next freeBlock
+        GenericObject *next = freeBlock->Next;
+        OAPoisonRegion(freeBlock, stats.ObjectSize_);
+        freeBlock = next;
     }
-    return false;
 }
 
 /**
- * @brief Frees all the data blocks in a given page from the free list
+ * @brief Records the live blocks, for DiffSnapshots. One walk of the pages and a sort, 8 bytes per
+ *  live block. Needs allocation numbers: a header block, or Lifetimes_ set to ltAllocations.
+ *  Blocks are grouped by label when TrackLabels_ is set.
  * 
- * @param page Page to be freed
+ * @return OASnapshot The live blocks, empty if the configuration has no allocation numbers
+ * @exception std::bad_alloc No memory for the snapshot
  */
-void ObjectAllocator::FreePage(GenericObject *page)
+OASnapshot ObjectAllocator::TakeLiveSnapshot() const
 {
-    GenericObject *freeBlock = FreeList_, *prev = nullptr;
-    while (freeBlock) //Deletes head node if its within the page
+    OASnapshot snapshot;
+    snapshot.Allocations_ = stats.Allocations_;
+    snapshot.ObjectSize_ = stats.ObjectSize_;
+    if (configuration.HBlockInfo_.type_ == OAConfig::HBLOCK_TYPE::hbNone && configuration.Lifetimes_ != OAConfig::ltAllocations)
+        return snapshot;
+
+    snapshot.Live_.reserve(stats.ObjectsInUse_);
+    OpenPages();
+    for (GenericObject *page = PageList_; page; page = page->Next)
     {
-        if ((reinterpret_cast<unsigned char *>(freeBlock) >= reinterpret_cast<unsigned char *>(page) && reinterpret_cast<unsigned char *>(freeBlock) < reinterpret_cast<unsigned char *>(page) + stats.PageSize_)) //If freeblock is within page
+        unsigned char *obj = reinterpret_cast<unsigned char *>(page) + pageHeader;
+        unsigned objects = PageObjects(page);
+        for (unsigned i = 0; i < objects; ++i, obj += dataSize)
         {
-            FreeList_ = freeBlock->Next;
-            freeBlock = FreeList_;
-            --stats.FreeObjects_;
+            OASnapshotEntry entry;
+            if (!LiveAllocNum(obj, entry.AllocNum_))
+                continue;
+            entry.Label_ = labels ? TagOf(obj)->label_ : LabelTable::NO_LABEL;
+            snapshot.Live_.push_back(entry);
         }
-        else
-            break;
     }
+    ClosePages();
+    std::sort(snapshot.Live_.begin(), snapshot.Live_.end(), [](const OASnapshotEntry &a, const OASnapshotEntry &b) {
+        return a.AllocNum_ < b.AllocNum_;
+    });
+    return snapshot;
+}
+
+/**
+ * @brief Reports, per label, the blocks allocated after a and still live at b, and the blocks of a
+ *  freed by b. Labels are reported largest growth first.
+ * 
+ * @param a Earlier snapshot of this allocator
+ * @param b Later snapshot of this allocator
+ * @param fn Callback function, called with the label name (null for unlabelled blocks)
+ * @return unsigned Number of labels reported
+ */
+unsigned ObjectAllocator::DiffSnapshots(const OASnapshot &a, const OASnapshot &b, SNAPSHOTCALLBACK fn) const
+{
+    std::vector<OASnapshotDelta> deltas = ::DiffSnapshots(a, b);
+    for (const OASnapshotDelta &delta : deltas)
+        fn(labels ? labels->Name(delta.Label_) : nullptr, delta);
+    return static_cast<unsigned>(deltas.size());
+}
+
+/**
+ * @brief Reports the live blocks that are at least minAge old, grouped by label (one group when
+ *  TrackLabels_ is off). One walk of the pages, cheap enough to run periodically.
+ * 
+ * @param minAge Threshold, in allocations or in cycles
+ * @param unit ltAllocations: age is the number of allocations made since the block's own, from the
+ *  header or the tag (ltAllocations). ltCycles: age is the time since the block's birth, requires
+ *  Lifetimes_ = ltCycles.
+ * @param fn Callback function, called with the label name (null for unlabelled blocks)
+ * @return unsigned Number of labels reported, 0 if the configuration doesn't record the ages
+ * @exception std::bad_alloc No memory for the groups
+ */
+unsigned ObjectAllocator::DumpStaleObjects(unsigned long long minAge, OAConfig::LIFETIME_TYPE unit, STALECALLBACK fn) const
+{
+    bool byCycles = unit == OAConfig::ltCycles;
+    if (byCycles ? configuration.Lifetimes_ != OAConfig::ltCycles
+                 : configuration.HBlockInfo_.type_ == OAConfig::HBLOCK_TYPE::hbNone && configuration.Lifetimes_ != OAConfig::ltAllocations)
+        return 0;
+    if (!byCycles && stats.Allocations_ < minAge)
+        return 0; //nothing is that old yet
 
-    while (freeBlock) // Delete everything other than head if its within page
+    unsigned long long now = byCycles ? Now() : stats.Allocations_;
+    std::vector<OAStaleStats> groups;
+    OpenPages();
+    for (GenericObject *page = PageList_; page; page = page->Next)
     {
-        if (!(reinterpret_cast<unsigned char *>(freeBlock) >= reinterpret_cast<unsigned char *>(page)                       // Search for the freeBlock to be deleted
-              && reinterpret_cast<unsigned char *>(freeBlock) < reinterpret_cast<unsigned char *>(page) + stats.PageSize_)) //If freeblock is NOT within page
-        {
-            prev = freeBlock;            //Keep track of prev as it is needed for unlinking nodes
-            freeBlock = freeBlock->Next; //Go to the next freeBlock on freeList
-        }
-        else
+        unsigned char *obj = reinterpret_cast<unsigned char *>(page) + pageHeader;
+        unsigned objects = PageObjects(page);
+        for (unsigned i = 0; i < objects; ++i, obj += dataSize)
         {
-            if (freeBlock == nullptr)
-                break;
-            prev->Next = freeBlock->Next; //Unlink node, prev node now points to the nextnextFreeBlock, unlinking the node in the middle
-            freeBlock = prev->Next;       //Update current freeBlock to be the nextnextFreeBlock
-            --stats.FreeObjects_;
+            unsigned long long birth;
+            if (byCycles)
+                birth = TagOf(obj)->birth_; //0 once freed
+            else
+            {
+                unsigned allocNum;
+                birth = LiveAllocNum(obj, allocNum) ? allocNum : 0;
+            }
+            if (!birth || now - birth < minAge)
+                continue;
+
+            unsigned label = labels ? TagOf(obj)->label_ : LabelTable::NO_LABEL;
+            if (label >= groups.size())
+                groups.resize(label + 1);
+            OAStaleStats &group = groups[label];
+            group.Label_ = label;
+            ++group.Objects_;
+            group.Bytes_ += stats.ObjectSize_;
+            if (now - birth > group.OldestAge_ || !group.Oldest_)
+            {
+                group.OldestAge_ = now - birth;
+                group.Oldest_ = obj;
+            }
         }
     }
+    ClosePages();
 
-    delete[] reinterpret_cast<unsigned char *>(page);
-    stats.PagesInUse_--;
-}
\ No newline at end of file
+    unsigned count = 0;
+    for (const OAStaleStats &group : groups)
+    {
+        if (!group.Objects_)
+            continue;
+        fn(labels ? labels->Name(group.Label_) : nullptr, group);
+        ++count;
+    }
+    return count;
+}
@@ -17,6 +17,17 @@
 //---------------------------------------------------------------------------
 
 #include <string>
+#include <atomic>
+#include <vector>
+#include "LabelTable.h"
+#include "LifetimeProfile.h"
+#include "HeapSnapshot.h"
+
+class HeapProfiler;
+class PageProvisioner;
+class PageReclaimer;
+class PageCache;
+struct iovec;
 
 // If the client doesn't specify these:
 static const int DEFAULT_OBJECTS_PER_PAGE = 4;  
@@ -95,6 +106,11 @@ struct OAConfig
   */
   enum HBLOCK_TYPE{hbNone, hbBasic, hbExtended, hbExternal};
 
+  /*!
+    The different units block lifetimes can be measured in
+  */
+  enum LIFETIME_TYPE{ltNone, ltAllocations, ltCycles};
+
   /*!
     POD that stores the information related to the header blocks.
   */
@@ -167,6 +183,16 @@ struct OAConfig
     HBlockInfo_ = HBInfo;
     LeftAlignSize_ = 0;  
     InterAlignSize_ = 0;
+    TrackLabels_ = false;
+    Lifetimes_ = ltNone;
+    AdaptivePages_ = false;
+    MinObjectsPerPage_ = ObjectsPerPage;
+    MaxObjectsPerPage_ = ObjectsPerPage;
+    PageBytes_ = 0;
+    ProvisionWatermark_ = 0;
+    Poison_ = false;
+    IOAlignment_ = 0;
+    Checksums_ = false;
   }
 
   bool UseCPPMemManager_;      //!< by-pass the functionality of the OA and use new/delete
@@ -178,6 +204,16 @@ struct OAConfig
   unsigned Alignment_;         //!< address alignment of each block
   unsigned LeftAlignSize_;     //!< number of alignment bytes required to align first block
   unsigned InterAlignSize_;    //!< number of alignment bytes required between remaining blocks
+  bool TrackLabels_;           //!< keep live usage counters per label (adds a hidden tag to each block)
+  LIFETIME_TYPE Lifetimes_;    //!< unit of the lifetime histograms (ltNone=off, adds a hidden tag to each block)
+  bool AdaptivePages_;         //!< tune ObjectsPerPage_ of new pages from the observed usage
+  unsigned MinObjectsPerPage_; //!< smallest page the adaptive mode may create
+  unsigned MaxObjectsPerPage_; //!< largest page the adaptive mode may create
+  size_t PageBytes_;           //!< exact size of each page in bytes (0=derive it from ObjectsPerPage_), overrides ObjectsPerPage_ and AdaptivePages_
+  unsigned ProvisionWatermark_; //!< prepare the next page in advance when fewer objects than this are free (0=off)
+  bool Poison_;                //!< poison pads, headers, alignment and free blocks for ASan/Valgrind (sanitizer builds only)
+  unsigned IOAlignment_;       //!< align the address of each block for direct I/O, e.g. 512 or 4096 (0=off, power of 2)
+  bool Checksums_;             //!< CRC32C of each block's tag, header and free list link, checked by Allocate, Free and ValidatePages (adds a hidden tag to each block; costs tens of ns per Allocate/Free, less with SSE4.2)
 };
 
 
@@ -190,7 +226,7 @@ struct OAStats
     Constructor
   */
   OAStats() : ObjectSize_(0), PageSize_(0), FreeObjects_(0), ObjectsInUse_(0), PagesInUse_(0),
-                  MostObjects_(0), Allocations_(0), Deallocations_(0) {};
+                  MostObjects_(0), Allocations_(0), Deallocations_(0), PageGrowths_(0), PageShrinks_(0) {};
 
   size_t ObjectSize_;      //!< size of each object
   size_t PageSize_;        //!< size of a page including all headers, padding, etc.
@@ -200,6 +236,31 @@ struct OAStats
   unsigned MostObjects_;   //!< most objects in use by client at one time
   unsigned Allocations_;   //!< total requests to allocate memory
   unsigned Deallocations_; //!< total requests to free memory
+  unsigned PageGrowths_;   //!< times the adaptive mode made new pages larger
+  unsigned PageShrinks_;   //!< times the adaptive mode made new pages smaller
+};
+
+/*!
+  POD that holds the sizes ObjectAllocator derives from the object size and the configuration
+*/
+struct OALayout
+{
+  /*!
+    Constructor
+  */
+  OALayout() : ObjectsPerPage_(0), PageHeader_(0), BlockSize_(0), PageSize_(0), PageAllocSize_(0), PageAlignment_(0),
+               TagSize_(0), PageInfoSize_(0), LeftAlignSize_(0), InterAlignSize_(0) {};
+
+  unsigned ObjectsPerPage_; //!< number of objects on each page (0 if PageBytes_ can't hold one)
+  size_t PageHeader_;       //!< bytes from the start of a page to the first object
+  size_t BlockSize_;        //!< bytes from one object to the next (header, padding and alignment included)
+  size_t PageSize_;         //!< size of a page including all headers, padding, etc.
+  size_t PageAllocSize_;    //!< bytes requested from the system for each page
+  size_t PageAlignment_;    //!< alignment of the memory of each page (0=whatever new[] gives)
+  size_t TagSize_;          //!< size of the hidden BlockTag in front of each header, with the bytes that align it (0=none)
+  size_t PageInfoSize_;     //!< size of the object count after the page's Next pointer (adaptive mode only)
+  unsigned LeftAlignSize_;  //!< number of alignment bytes required to align first block
+  unsigned InterAlignSize_; //!< number of alignment bytes required between remaining blocks
 };
 
 /*!
@@ -210,6 +271,16 @@ struct GenericObject
   GenericObject *Next; //!< The next object in the list
 };
 
+/*!
+  Hidden bookkeeping stored in front of the header of each block when tracking is enabled
+*/
+struct BlockTag
+{
+  unsigned checksum_;        //!< CRC32C of the block's metadata when Checksums_ is set
+  unsigned label_;           //!< LabelTable id of the label the block was allocated with
+  unsigned long long birth_; //!< allocation count or cycle count when allocated (0=free)
+};
+
 /*!
   This is used with external headers
 */
@@ -232,6 +303,10 @@ class ObjectAllocator
       // Defined by the client (pointer to a block, size of block)
     typedef void (*DUMPCALLBACK)(const void *, size_t);     //!< Callback function when dumping memory leaks
     typedef void (*VALIDATECALLBACK)(const void *, size_t); //!< Callback function when validating blocks
+    typedef void (*LABELCALLBACK)(const char *, const OALabelStats &); //!< Callback function when dumping label usage
+    typedef void (*SNAPSHOTCALLBACK)(const char *, const OASnapshotDelta &); //!< Callback function when diffing snapshots
+    typedef void (*STALECALLBACK)(const char *, const OAStaleStats &); //!< Callback function when dumping stale blocks
+    typedef bool (*OOMHANDLER)(ObjectAllocator &, OAException::OA_EXCEPTION); //!< Called before E_NO_PAGES/E_NO_MEMORY is thrown, true=retry
 
       // Predefined values for memory signatures
     static const unsigned char UNALLOCATED_PATTERN = 0xAA; //!< New memory never given to the client
@@ -240,6 +315,9 @@ class ObjectAllocator
     static const unsigned char PAD_PATTERN =         0xDD; //!< Pad signature to detect buffer over/under flow
     static const unsigned char ALIGN_PATTERN =       0xEE; //!< For the alignment bytes
 
+      // Sizes an allocator of ObjectSize objects would use with config (never throws)
+    static OALayout Layout(size_t ObjectSize, const OAConfig &config);
+
       // Creates the ObjectManager per the specified values
       // Throws an exception if the construction fails. (Memory allocation problem)
     ObjectAllocator(size_t ObjectSize, const OAConfig& config);
@@ -255,6 +333,12 @@ class ObjectAllocator
       // Throws an exception if the the object can't be freed. (Invalid object)
     void Free(void *Object);
 
+      // Allocates count blocks into iov for readv/writev, all or none (throws like Allocate)
+    void AllocateIov(unsigned count, struct iovec *iov, const char *label = 0);
+
+      // Frees the count blocks of iov
+    void FreeIov(unsigned count, const struct iovec *iov);
+
       // Calls the callback fn for each block still in use
     unsigned DumpMemoryInUse(DUMPCALLBACK fn) const;
 
@@ -264,8 +348,38 @@ class ObjectAllocator
       // Frees all empty page
     unsigned FreeEmptyPages();
 
+      // Usage of one label (requires TrackLabels_, a null label is the unlabelled usage)
+    OALabelStats GetLabelStats(const char *label) const;
+
+      // Calls the callback fn for each label seen so far, returns the number of labels
+    unsigned DumpLabelStats(LABELCALLBACK fn) const;
+
+      // Lifetimes of the freed blocks, of the whole allocator or of one label (requires Lifetimes_)
+    OALifetimeHistogram GetLifetimeHistogram() const;
+    OALifetimeHistogram GetLifetimeHistogram(const char *label) const;
+
+      // Copies up to count of the longest-lived freed blocks into out, returns how many were copied
+    unsigned GetLongestLived(OALongLived *out, unsigned count) const;
+
+      // Records the live blocks (requires a header block, or Lifetimes_ = ltAllocations)
+    OASnapshot TakeLiveSnapshot() const;
+
+      // Calls the callback fn for each label whose live blocks changed from a to b, largest growth first
+    unsigned DiffSnapshots(const OASnapshot &a, const OASnapshot &b, SNAPSHOTCALLBACK fn) const;
+
+      // Calls the callback fn for each label with live blocks at least minAge old, in allocations
+      // (ltAllocations, needs allocation numbers) or cycles (ltCycles, needs Lifetimes_ = ltCycles)
+    unsigned DumpStaleObjects(unsigned long long minAge, OAConfig::LIFETIME_TYPE unit, STALECALLBACK fn) const;
+
       // Testing/Debugging/Statistic methods
-    void SetDebugState(bool State);   // true=enable, false=disable
+    void SetDebugState(bool State);   // true=enable, false=disable (safe on a live pool, pages made while off are painted lazily)
+    void SetProfiler(HeapProfiler *Profiler); // samples allocations into Profiler (null=off)
+    OOMHANDLER SetOOMHandler(OOMHANDLER Handler); // like std::set_new_handler, returns the previous handler
+    void SetMaxPages(unsigned MaxPages);      // changes the page limit (0=unlimited), e.g. from an OOM handler
+    void SetProvisioner(PageProvisioner *Provisioner); // background thread that prepares spare pages (null=off)
+    bool PrepareSparePage();                  // prepares the spare page now if below ProvisionWatermark_, true if one was made
+    void SetReclaimer(PageReclaimer *Reclaimer); // FreeEmptyPages hands pages to Reclaimer instead of deleting them (null=off)
+    bool SetPageCache(PageCache *Cache);      // takes new pages from Cache and gives empty ones back (null=off), false if its pages don't fit
     const void *GetFreeList() const;  // returns a pointer to the internal free list
     const void *GetPageList() const;  // returns a pointer to the internal page list
     OAConfig GetConfig() const;       // returns the configuration parameters
@@ -276,6 +390,8 @@ class ObjectAllocator
     ObjectAllocator &operator=(const ObjectAllocator &oa) = delete; //!< Do not implement!
 
   private:
+    friend class PageProvisioner;
+
       // Some "suggested" members (only a suggestion!)
     GenericObject *PageList_; //!< the beginning of the list of pages
     GenericObject *FreeList_; //!< the beginning of the list of objects
@@ -286,14 +402,95 @@ class ObjectAllocator
     size_t pageHeader;                  // Header of page size
     size_t dataSize;                    // The size of each mid block
     size_t totalDataSize;               // Total size of mid data blocks and last data  block
+    size_t pageInfoSize;                // Size of the object count after the page's Next pointer (adaptive mode only)
+    size_t pageAlignment;               // Alignment of the page memory with PageBytes_ or IOAlignment_ (0=new[])
+    unsigned recentMostObjects;         // Most objects in use since the last adaptive decision
+    unsigned recentReleases;            // Pages released since the last adaptive decision
+    bool churned;                       // Released pages had to be created again since the last release
+    size_t tagSize;                     // Size of the hidden BlockTag in front of each header (0=none)
+    LabelTable *labels;                 // Per-label usage, only when TrackLabels_ is set
+    HeapProfiler *profiler;             // Sampling heap profiler (not owned), may be null
+    LifetimeProfile *lifetimes;         // Lifetime histograms, only when Lifetimes_ is set
+    OOMHANDLER oomHandler;              // Client hook called when the pool can't grow, may be null
+    bool inOOMHandler;                  // Set while oomHandler runs, so it can't recurse into itself
+    PageProvisioner *provisioner;       // Background page preparation (not owned), may be null
+    std::atomic<GenericObject *> sparePage; // Page prepared in advance, linked in when the free list runs dry
+    std::atomic<bool> sparePending;     // A spare page was requested from provisioner and isn't done yet
+    unsigned spareObjects;              // Object count of the requested spare page
+    bool spareDebug;                    // Debug state the spare page is painted for
+    PageReclaimer *reclaimer;           // Background page deletion (not owned), may be null
+    PageCache *pageCache;               // Empty pages shared with other allocators (not owned), may be null
+    unsigned char *pageTemplate;        // Painted empty debug page, copied by CreatePage (null until a debug page is made)
+    unsigned templateObjects;           // Object count of pageTemplate
+    bool poisoning;                     // Poison_ is set and a sanitizer is compiled in
+    bool checksums;                     // Checksums_ is set and the pages are in use
+    bool hardwareCrc;                   // checksums are computed with the inlined SSE4.2 CRC32C
+    size_t freeMetadata;                // bytes of tag and header hashed, all zeros in a free block (0=not so, extended headers)
+    unsigned freeSeed;                  // CRC32C of freeMetadata zeros, the seal of a free block only adds its link
+
+    /*!
+      A page created while DebugOn_ was off, whose pads aren't painted yet
+    */
+    struct UnpaintedPage
+    {
+      GenericObject *page_;       //!< the page
+      unsigned remaining_;        //!< blocks not painted yet
+      std::vector<bool> painted_; //!< painted blocks (empty until debugging is switched on)
+    };
+    std::vector<UnpaintedPage> unpainted; // pages made while DebugOn_ was off (PadBytes_ only), sorted by address while it is on
+
+    /*!
+      Free blocks of a page, used by FreeEmptyPages
+    */
+    struct PageUsage
+    {
+      GenericObject *page_; //!< the page
+      unsigned free_;       //!< its blocks on the free list
+      bool empty_;          //!< every block is free
+    };
 
     //Functions
-    void AllocateNewPage(GenericObject* &page);       // allocates new page
+    void AllocateNewPage();                 // allocates new page
+    GenericObject *CreatePage(unsigned objects, bool debug) const; // initialised page with its blocks linked, not in any list
+    void LinkPage(GenericObject *page);     // adds a page from CreatePage to the page list and free list
+    void PaintPage(unsigned char *page, unsigned objects) const; // writes the debug signatures of an empty page
+    void UpdatePageTemplate();              // repaints pageTemplate if ObjectsPerPage_ changed
+    GenericObject *TakeSparePage();         // the spare page if it is ready and usable
+    void RequestSparePage();                // asks the provisioner for a spare page
+    void ProvisionSparePage();              // called on the provisioner thread
+    void RefillFreeList();                  // allocates pages until FreeList_ isn't empty, calling oomHandler on failure
+    bool HandleOOM(OAException::OA_EXCEPTION code); // runs oomHandler, true if the failed operation should be retried
     void AddToFreeList(GenericObject* obj); //Adds object to start of freelist
+    void FreeBlock(void *obj);              // checks obj and puts it back on the free list
     void CheckPageBoundary(const unsigned char* obj);
     void CheckPadding(const unsigned char* obj);
-    bool IsPageEmpty(GenericObject* page);
-    void FreePage(GenericObject* page);
+    size_t FindUnpainted(const void *obj) const; // index in unpainted of the page of obj, unpainted.size() if painted
+    bool RepaintBlock(unsigned char *obj);  // paints the pads of obj if they aren't yet, false if they already were
+    void PaintFreeBlocks();                 // debugging switched on: paints the free blocks
+    static PageUsage *FindPage(std::vector<PageUsage> &pages, const void *obj); // page of obj, pages sorted by address
+    void ReleasePage(GenericObject* page);  // gives an unlinked page to pageCache, to reclaimer or deletes it
+    unsigned char *HeaderStart(void *obj) const; // start of the header block of obj
+    BlockTag *TagOf(void *obj) const;            // hidden tag of obj (tagSize must not be 0)
+    unsigned long long Now() const;              // current time in the unit of Lifetimes_
+    unsigned BlockChecksum(void *obj, bool free) const; // CRC32C of the metadata of obj, as a free or a live block
+    unsigned FreeChecksum(void *obj) const;             // BlockChecksum of a free block, hashing only the link if it can
+    unsigned ZeroedFreeChecksum(GenericObject *link) const; // the same for a free block known to have zeroed metadata
+    void SealBlock(void *obj, bool free) const;         // stores BlockChecksum in the tag of obj
+    bool ChecksumMatches(void *obj) const;              // the tag of obj holds its free or live checksum
+    unsigned PageObjects(const GenericObject *page) const; // number of blocks on page
+    size_t PageBytes(const GenericObject *page) const;     // size of page including all headers, padding, etc.
+    bool IsOnPage(const void *obj, const GenericObject *page) const;
+    bool LiveAllocNum(unsigned char *obj, unsigned &allocNum) const; // allocation number of obj if it is live
+    void OpenBlock(void *obj) const;              // unpoisons the tag, header, pads and data of a block
+    void CloseBlock(void *obj, bool live) const;  // poisons them again, except the data of a live block
+    void OpenPages() const;                       // unpoisons every page, before walking them
+    void ClosePages() const;                      // poisons everything but the live data again
+    void SetObjectsPerPage(unsigned count);      // size of the pages created from now on
+    size_t PageBytesFor(unsigned objects) const; // size of a page of objects blocks
+    unsigned char *NewPageMemory(size_t bytes) const; // raw memory for one page (throws std::bad_alloc)
+    void DeletePageMemory(GenericObject *page) const; // gives the memory of a page back to the system
+    void AdaptOnNewPage();                       // adaptive mode: maybe grow before creating a page
+    void AdaptOnRelease(unsigned pagesFreed);    // adaptive mode: maybe shrink after releasing pages
 };
 
 #endif
@@ -0,0 +1,134 @@
+/**
+ * @file PageCache.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements PageCache, the store of empty pages shared across size classes.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "PageCache.h"
+#include "OAPoison.h"
+#include <new>
+
+const unsigned PageCache::DEFAULT_CAPACITY;
+
+static const size_t OS_PAGE_SIZE = 4096; //Alignment of the pages, as in ObjectAllocator
+
+/**
+ * @brief Construct a new PageCache
+ *
+ * @param PageBytes Size of the pages, the OAConfig::PageBytes_ of the allocators using the cache
+ * @param Capacity Most pages kept
+ * @exception std::bad_alloc No memory for the list of pages
+ */
+PageCache::PageCache(size_t PageBytes, unsigned Capacity)
+    : hits_{0}, misses_{0}, pageBytes_{PageBytes},
+      alignment_{OS_PAGE_SIZE}, capacity_{Capacity}
+{
+    pages_.reserve(Capacity);
+}
+
+/**
+ * @brief Destroy the PageCache, deleting the pages it still holds
+ *
+ */
+PageCache::~PageCache()
+{
+    Trim();
+}
+
+/**
+ * @brief Takes a page out of the cache
+ *
+ * @return void* A page of PageBytes() bytes with unspecified contents, or null if the cache is empty
+ */
+void *PageCache::Take()
+{
+    void *page = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pages_.empty())
+        {
+            ++misses_;
+            return nullptr;
+        }
+        page = pages_.back(); //most recently released, the likeliest to still be in cache
+        pages_.pop_back();
+        ++hits_;
+    }
+    OAUnpoisonRegion(page, pageBytes_);
+    return page;
+}
+
+/**
+ * @brief Keeps an empty page for the next Take. The page is poisoned while it is cached, so a stale
+ *  pointer into it is reported by the sanitizer.
+ *
+ * @param page Page of PageBytes() bytes allocated with Alignment(), no longer used by its allocator
+ * @return true The cache owns the page
+ * @return false The cache is full, the page is still the caller's
+ */
+bool PageCache::Put(void *page)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pages_.size() >= capacity_)
+        return false;
+    OAPoisonRegion(page, pageBytes_);
+    pages_.push_back(page);
+    return true;
+}
+
+/**
+ * @brief Gives every cached page back to the system
+ *
+ * @return unsigned Number of pages deleted
+ */
+unsigned PageCache::Trim()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    unsigned count = static_cast<unsigned>(pages_.size());
+    for (void *page : pages_)
+    {
+        OAUnpoisonRegion(page, pageBytes_);
+        ::operator delete(page, std::align_val_t(alignment_));
+    }
+    pages_.clear(); //keeps the reserved capacity
+    return count;
+}
+
+/**
+ * @brief Number of pages in the cache
+ *
+ * @return unsigned Count
+ */
+unsigned PageCache::Cached() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<unsigned>(pages_.size());
+}
+
+/**
+ * @brief Number of Take calls that returned a page
+ *
+ * @return unsigned long long Count
+ */
+unsigned long long PageCache::Hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+/**
+ * @brief Number of Take calls that found the cache empty
+ *
+ * @return unsigned long long Count
+ */
+unsigned long long PageCache::Misses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file PageCache.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of PageCache, a store of empty pages of one byte size shared
+ * by allocators of different object sizes.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef PAGECACHEH
+#define PAGECACHEH
+//---------------------------------------------------------------------------
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/*!
+  Empty pages of PageBytes bytes, shared by every allocator whose OAConfig::PageBytes_ is PageBytes.
+  Each of those allocators derives its own object count from the page size, so a page emptied by
+  FreeEmptyPages in one size class can be reformatted by CreatePage in any other instead of going
+  back to the system. At most Capacity pages are kept, the rest are deleted as usual. Thread-safe.
+*/
+class PageCache
+{
+  public:
+    static const unsigned DEFAULT_CAPACITY = 64; //!< pages kept before released ones are deleted
+
+      // Creates an empty cache of pages of PageBytes bytes, aligned like ObjectAllocator aligns them
+    explicit PageCache(size_t PageBytes, unsigned Capacity = DEFAULT_CAPACITY);
+    ~PageCache(); // deletes the cached pages, every allocator using the cache must be gone
+
+      // A cached page, null if there is none (the caller allocates one)
+    void *Take();
+
+      // Keeps an empty page, false if the cache is full (the caller deletes it)
+    bool Put(void *page);
+
+      // Deletes every cached page, returns how many
+    unsigned Trim();
+
+    size_t PageBytes() const { return pageBytes_; } // size of the pages
+    size_t Alignment() const { return alignment_; } // alignment the pages are allocated with
+    unsigned Cached() const;                        // pages in the cache
+    unsigned long long Hits() const;                // Take calls that returned a page
+    unsigned long long Misses() const;              // Take calls that found the cache empty
+
+      // Prevent copy construction and assignment
+    PageCache(const PageCache &) = delete;            //!< Do not implement!
+    PageCache &operator=(const PageCache &) = delete; //!< Do not implement!
+
+  private:
+    mutable std::mutex mutex_;   // guards everything below
+    std::vector<void *> pages_;  // the cached pages, reserved up front so Put never allocates
+    unsigned long long hits_;    // Take calls served from pages_
+    unsigned long long misses_;  // Take calls that found pages_ empty
+    size_t pageBytes_;           // size of every page
+    size_t alignment_;           // alignment given to operator new
+    unsigned capacity_;          // most pages kept
+};
+
+#endif
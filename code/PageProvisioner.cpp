@@ -0,0 +1,87 @@
+/**
+ * @file PageProvisioner.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements PageProvisioner, the background thread that prepares spare pages.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "PageProvisioner.h"
+#include "ObjectAllocator.h"
+#include <algorithm>
+
+/**
+ * @brief Construct a new PageProvisioner and start its worker
+ *
+ */
+PageProvisioner::PageProvisioner()
+    : current_{nullptr}, stop_{false}, worker_{&PageProvisioner::Run, this}
+{
+}
+
+/**
+ * @brief Stops the worker. Allocators still attached must have been destroyed or detached.
+ *
+ */
+PageProvisioner::~PageProvisioner()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    requested_.notify_one();
+    worker_.join();
+}
+
+/**
+ * @brief Queues an allocator for a spare page
+ *
+ * @param oa Allocator that is running low
+ */
+void PageProvisioner::Request(ObjectAllocator *oa)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(oa);
+    }
+    requested_.notify_one();
+}
+
+/**
+ * @brief Forgets an allocator. On return the worker doesn't touch it any more.
+ *
+ * @param oa Allocator being destroyed or detached
+ */
+void PageProvisioner::Cancel(ObjectAllocator *oa)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.erase(std::remove(queue_.begin(), queue_.end(), oa), queue_.end());
+    done_.wait(lock, [this, oa] { return current_ != oa; });
+    oa->sparePending.store(false, std::memory_order_release); //a dropped request may be made again
+}
+
+/**
+ * @brief Worker loop, prepares one page at a time outside the lock
+ *
+ */
+void PageProvisioner::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        requested_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (stop_)
+            return;
+        current_ = queue_.front();
+        queue_.pop_front();
+        lock.unlock();
+        current_->ProvisionSparePage();
+        lock.lock();
+        current_ = nullptr;
+        done_.notify_all();
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file PageProvisioner.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of PageProvisioner, a background thread that prepares the
+ * next page of ObjectAllocators before their free lists run dry.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef PAGEPROVISIONERH
+#define PAGEPROVISIONERH
+//---------------------------------------------------------------------------
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+class ObjectAllocator;
+
+/*!
+  Worker thread shared by any number of allocators. An allocator whose free objects drop below
+  OAConfig::ProvisionWatermark_ queues itself, the worker allocates and paints a page for it, and
+  the allocator links that page in O(1) when it next needs one.
+*/
+class PageProvisioner
+{
+  public:
+    PageProvisioner();  // starts the worker thread
+    ~PageProvisioner(); // stops and joins it, requests still queued are dropped
+
+      // Queues oa, the worker calls oa->ProvisionSparePage()
+    void Request(ObjectAllocator *oa);
+
+      // Drops the requests of oa and waits if the worker is preparing a page for it
+    void Cancel(ObjectAllocator *oa);
+
+      // Prevent copy construction and assignment
+    PageProvisioner(const PageProvisioner &) = delete;            //!< Do not implement!
+    PageProvisioner &operator=(const PageProvisioner &) = delete; //!< Do not implement!
+
+  private:
+    std::mutex mutex_;                    // guards everything below
+    std::condition_variable requested_;   // signalled by Request and the destructor
+    std::condition_variable done_;        // signalled when the worker finishes a page
+    std::deque<ObjectAllocator *> queue_; // allocators waiting for a spare page
+    ObjectAllocator *current_;            // allocator the worker is preparing a page for
+    bool stop_;                           // set by the destructor
+    std::thread worker_;                  // started last, after everything it uses
+
+    void Run(); // worker loop
+};
+
+#endif
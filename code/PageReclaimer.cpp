@@ -0,0 +1,158 @@
+/**
+ * @file PageReclaimer.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements PageReclaimer, the background thread that deletes released pages.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "PageReclaimer.h"
+#include <new>
+
+const unsigned PageReclaimer::DEFAULT_BATCH_SIZE;
+const unsigned PageReclaimer::DEFAULT_INTERVAL_MS;
+
+/**
+ * @brief Construct a new PageReclaimer and start its worker
+ *
+ * @param BatchSize Number of waiting pages that wakes the worker (at least 1)
+ * @param Interval Longest a released page waits for its batch to fill
+ */
+PageReclaimer::PageReclaimer(unsigned BatchSize, std::chrono::milliseconds Interval)
+    : released_count_{0}, reclaimed_count_{0}, batchSize_{BatchSize ? BatchSize : 1}, interval_{Interval},
+      flush_{false}, stop_{false}, worker_{&PageReclaimer::Run, this}
+{
+}
+
+/**
+ * @brief Stops the worker, then deletes whatever it left behind
+ *
+ */
+PageReclaimer::~PageReclaimer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    released_.notify_one();
+    worker_.join();
+    DeletePages(pending_);
+}
+
+/**
+ * @brief Hands a page over to the worker. If there is no memory to queue it, deletes it right away
+ *  instead: the allocator has already unlinked it, so it must not be lost
+ *
+ * @param page Page memory, no longer referenced by its allocator
+ * @param alignment Alignment it was allocated with, 0 if it came from new unsigned char[]
+ */
+void PageReclaimer::Release(void *page, size_t alignment) noexcept
+{
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            pending_.push_back(Page{page, alignment});
+        }
+        catch (std::bad_alloc &)
+        {
+            DeletePage(Page{page, alignment});
+            return;
+        }
+        ++released_count_;
+        wake = pending_.size() >= batchSize_;
+    }
+    if (wake)
+        released_.notify_one();
+}
+
+/**
+ * @brief Waits until every page released before the call has been deleted
+ *
+ */
+void PageReclaimer::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    unsigned long long target = released_count_;
+    flush_ = true;
+    released_.notify_one();
+    reclaimed_.wait(lock, [this, target] { return reclaimed_count_ >= target; });
+}
+
+/**
+ * @brief Number of pages the worker has deleted
+ *
+ * @return unsigned long long Count
+ */
+unsigned long long PageReclaimer::PagesReclaimed() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reclaimed_count_;
+}
+
+/**
+ * @brief Number of pages waiting to be deleted
+ *
+ * @return unsigned Count
+ */
+unsigned PageReclaimer::Pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<unsigned>(pending_.size());
+}
+
+/**
+ * @brief Worker loop, takes the whole batch and deletes it outside the lock
+ *
+ */
+void PageReclaimer::Run()
+{
+    std::vector<Page> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        released_.wait_for(lock, interval_, [this] { return stop_ || flush_ || pending_.size() >= batchSize_; });
+        if (stop_)
+            return;
+        flush_ = false;
+        if (pending_.empty())
+            continue;
+        batch.swap(pending_);
+        size_t count = batch.size();
+        lock.unlock();
+        DeletePages(batch);
+        lock.lock();
+        reclaimed_count_ += count;
+        reclaimed_.notify_all();
+    }
+}
+
+/**
+ * @brief Deletes a page the way ObjectAllocator allocated it
+ *
+ * @param page Page to delete
+ */
+void PageReclaimer::DeletePage(const Page &page)
+{
+    if (page.alignment_)
+        ::operator delete(page.memory_, std::align_val_t(page.alignment_));
+    else
+        delete[] static_cast<unsigned char *>(page.memory_);
+}
+
+/**
+ * @brief Deletes pages the way ObjectAllocator allocated them
+ *
+ * @param pages Pages to delete, emptied
+ */
+void PageReclaimer::DeletePages(std::vector<Page> &pages)
+{
+    for (const Page &page : pages)
+        DeletePage(page);
+    pages.clear();
+}
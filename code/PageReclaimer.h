@@ -0,0 +1,81 @@
+/**
+ * @file PageReclaimer.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of PageReclaimer, a background thread that returns the
+ * pages released by FreeEmptyPages to the system in batches.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef PAGERECLAIMERH
+#define PAGERECLAIMERH
+//---------------------------------------------------------------------------
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+  Worker thread shared by any number of allocators. FreeEmptyPages only unlinks the empty pages
+  and hands them over, the worker deletes them once BatchSize pages are waiting or Interval has
+  passed, so munmap and the TLB shootdowns that come with it stay off the application thread.
+*/
+class PageReclaimer
+{
+  public:
+    static const unsigned DEFAULT_BATCH_SIZE = 16;     //!< pages that wake the worker
+    static const unsigned DEFAULT_INTERVAL_MS = 100;   //!< longest a released page waits
+
+      // Starts the worker thread
+    PageReclaimer(unsigned BatchSize = DEFAULT_BATCH_SIZE,
+                  std::chrono::milliseconds Interval = std::chrono::milliseconds(DEFAULT_INTERVAL_MS));
+    ~PageReclaimer(); // deletes what is still waiting, stops and joins the worker
+
+      // Takes ownership of a detached page (alignment 0 = allocated with new[]), deletes it at once if it can't queue it
+    void Release(void *page, size_t alignment) noexcept;
+
+      // Waits until every page released so far is deleted
+    void Flush();
+
+    unsigned long long PagesReclaimed() const; // pages deleted by the worker so far
+    unsigned Pending() const;                  // pages waiting to be deleted
+
+      // Prevent copy construction and assignment
+    PageReclaimer(const PageReclaimer &) = delete;            //!< Do not implement!
+    PageReclaimer &operator=(const PageReclaimer &) = delete; //!< Do not implement!
+
+  private:
+    /*!
+      A released page and how it was allocated
+    */
+    struct Page
+    {
+      void *memory_;     //!< start of the page
+      size_t alignment_; //!< alignment given to operator new, 0 for new[]
+    };
+
+    mutable std::mutex mutex_;            // guards everything below
+    std::condition_variable released_;    // signalled when a batch is full, by Flush and the destructor
+    std::condition_variable reclaimed_;   // signalled when the worker finishes a batch
+    std::vector<Page> pending_;           // pages waiting to be deleted
+    unsigned long long released_count_;   // pages handed over so far
+    unsigned long long reclaimed_count_;  // pages deleted so far
+    unsigned batchSize_;                  // pages that wake the worker
+    std::chrono::milliseconds interval_;  // longest a page waits
+    bool flush_;                          // Flush is waiting, delete even a partial batch
+    bool stop_;                           // set by the destructor
+    std::thread worker_;                  // started last, after everything it uses
+
+    void Run();                                    // worker loop
+    static void DeletePage(const Page &page);          // returns one page to the system
+    static void DeletePages(std::vector<Page> &pages); // returns a batch to the system
+};
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file PoolHashMap.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides PoolHashMap, a chained hash map whose nodes come from its own ObjectAllocator.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef POOLHASHMAPH
+#define POOLHASHMAPH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <cstddef>    // std::max_align_t
+#include <functional> // std::hash, std::equal_to
+#include <new>        // placement new
+#include <utility>    // std::forward, std::pair
+#include <vector>
+
+/*!
+  Hash map with separate chaining. Each node holds the key, the value, the full hash and the chain
+  link, and comes from a pool owned by the map, so inserting and erasing cost a free list pop or
+  push instead of a call to new/delete, and the nodes are packed in pages. The bucket array doubles
+  when there are more nodes than buckets; rehashing relinks the nodes without moving them, so
+  pointers to values stay valid until the key is erased. Not thread-safe, like ObjectAllocator.
+*/
+template <typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+class PoolHashMap
+{
+  public:
+    static const unsigned DEFAULT_NODES_PER_PAGE = 256; //!< nodes in each page of the pool
+    static const size_t MIN_BUCKETS = 16;               //!< buckets of an empty map
+
+      // Creates an empty map whose pool has NodesPerPage nodes per page
+    explicit PoolHashMap(unsigned NodesPerPage = DEFAULT_NODES_PER_PAGE)
+        : pool_{sizeof(Node), Config(NodesPerPage)}, buckets_(MIN_BUCKETS, nullptr), shift_(ShiftFor(MIN_BUCKETS)), size_(0)
+    {
+    }
+
+      // Destroys the keys and values, the pool releases the nodes
+    ~PoolHashMap() { Clear(); }
+
+      // Inserts key and a value constructed from args if key is absent
+      // Returns the value of key and whether it was inserted
+      // Throws an exception if the node can't be allocated
+    template <typename... Args>
+    std::pair<V *, bool> Emplace(const K &key, Args &&... args)
+    {
+      size_t hash = hasher_(key);
+      if (Node *node = FindNode(key, hash))
+        return std::pair<V *, bool>(&node->value_, false);
+
+      if (size_ >= buckets_.size()) //grow first, so a failure leaves nothing half inserted
+        Rehash(buckets_.size() * 2);
+      void *memory = pool_.Allocate();
+      Node *node;
+      try
+      {
+        node = new (memory) Node(key, hash, std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        pool_.Free(memory);
+        throw;
+      }
+      Node *&bucket = buckets_[Index(hash)];
+      node->next_ = bucket;
+      bucket = node;
+      ++size_;
+      return std::pair<V *, bool>(&node->value_, true);
+    }
+
+      // Inserts a copy of value if key is absent
+    std::pair<V *, bool> Insert(const K &key, const V &value) { return Emplace(key, value); }
+
+      // Value of key, null if absent
+    V *Find(const K &key)
+    {
+      Node *node = FindNode(key, hasher_(key));
+      return node ? &node->value_ : nullptr;
+    }
+
+      // Removes key, false if it was absent
+    bool Erase(const K &key)
+    {
+      size_t hash = hasher_(key);
+      for (Node **link = &buckets_[Index(hash)]; *link; link = &(*link)->next_)
+      {
+        Node *node = *link;
+        if (node->hash_ == hash && equal_(node->key_, key))
+        {
+          *link = node->next_;
+          node->~Node();
+          pool_.Free(node);
+          --size_;
+          return true;
+        }
+      }
+      return false;
+    }
+
+      // Calls fn(key, value) for each entry, in no particular order
+    template <typename Fn>
+    void ForEach(Fn fn)
+    {
+      for (Node *bucket : buckets_)
+        for (Node *node = bucket; node; node = node->next_)
+          fn(static_cast<const K &>(node->key_), node->value_);
+    }
+
+      // Removes every entry
+    void Clear()
+    {
+      for (Node *&bucket : buckets_)
+      {
+        while (Node *node = bucket)
+        {
+          bucket = node->next_;
+          node->~Node();
+          pool_.Free(node);
+        }
+      }
+      size_ = 0;
+    }
+
+    size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+    size_t BucketCount() const { return buckets_.size(); }
+    OAStats GetStats() const { return pool_.GetStats(); } // statistics of the node pool
+    unsigned FreeEmptyPages() { return pool_.FreeEmptyPages(); } // gives back the pages emptied by Erase
+
+      // Prevent copy construction and assignment
+    PoolHashMap(const PoolHashMap &) = delete;            //!< Do not implement!
+    PoolHashMap &operator=(const PoolHashMap &) = delete; //!< Do not implement!
+
+  private:
+    /*!
+      An entry and its chain link
+    */
+    struct Node
+    {
+      template <typename... Args>
+      Node(const K &key, size_t hash, Args &&... args)
+          : next_(nullptr), hash_(hash), key_(key), value_(std::forward<Args>(args)...) {}
+
+      Node *next_;  //!< next node of the bucket
+      size_t hash_; //!< hash of key_, compared before the keys and reused by Rehash
+      K key_;       //!< the key
+      V value_;     //!< the value
+    };
+
+      // Pool configuration, aligned for Node
+    static OAConfig Config(unsigned NodesPerPage)
+    {
+      OAConfig config(false, NodesPerPage ? NodesPerPage : 1, 0, false, 0, OAConfig::HeaderBlockInfo(),
+                      alignof(Node) > alignof(GenericObject) ? alignof(Node) : alignof(GenericObject));
+      if (alignof(Node) > alignof(std::max_align_t)) //over-aligned K or V, the pages must be aligned too
+        config.IOAlignment_ = alignof(Node);
+      return config;
+    }
+
+      // Node of key, null if absent
+    Node *FindNode(const K &key, size_t hash) const
+    {
+      for (Node *node = buckets_[Index(hash)]; node; node = node->next_)
+        if (node->hash_ == hash && equal_(node->key_, key))
+          return node;
+      return nullptr;
+    }
+
+      // Fibonacci hashing: the top bits of hash * 2^64/phi, so weak hashes (std::hash<int> is the
+      // identity) still spread over the buckets
+    size_t Index(size_t hash) const
+    {
+      return static_cast<size_t>((static_cast<unsigned long long>(hash) * 11400714819323198485ull) >> shift_);
+    }
+
+      // Shift of Index for count buckets (a power of 2)
+    static unsigned ShiftFor(size_t count)
+    {
+      unsigned shift = 64;
+      for (; count > 1; count >>= 1)
+        --shift;
+      return shift;
+    }
+
+      // Relinks every node into count buckets (a power of 2)
+    void Rehash(size_t count)
+    {
+      std::vector<Node *> buckets(count, nullptr);
+      shift_ = ShiftFor(count);
+      for (Node *bucket : buckets_)
+      {
+        while (Node *node = bucket)
+        {
+          bucket = node->next_;
+          Node *&target = buckets[Index(node->hash_)];
+          node->next_ = target;
+          target = node;
+        }
+      }
+      buckets_.swap(buckets);
+    }
+
+    ObjectAllocator pool_;        // the memory of every node
+    std::vector<Node *> buckets_; // chains, the count is a power of 2
+    unsigned shift_;              // 64 - log2 of the bucket count
+    size_t size_;                 // entries
+    Hash hasher_;
+    Equal equal_;
+};
+
+template <typename K, typename V, typename Hash, typename Equal>
+const unsigned PoolHashMap<K, V, Hash, Equal>::DEFAULT_NODES_PER_PAGE;
+template <typename K, typename V, typename Hash, typename Equal>
+const size_t PoolHashMap<K, V, Hash, Equal>::MIN_BUCKETS;
+
+#endif
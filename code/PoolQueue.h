@@ -0,0 +1,226 @@
+/**
+ * @file PoolQueue.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides PoolQueue, a bounded multi-producer multi-consumer queue whose nodes come
+ * from an ObjectAllocator and are recycled instead of being deleted.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef POOLQUEUEH
+#define POOLQUEUEH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <atomic>
+#include <cstddef> // std::max_align_t
+#include <mutex>
+#include <new>     // placement new
+#include <utility> // std::forward, std::move
+
+/*!
+  Two-lock Michael-Scott queue: producers only take the tail lock and consumers only the head lock,
+  so a push and a pop never wait for each other. The head is a dummy node; a pop moves the value out
+  of the node after the head, which becomes the new dummy, and retires the old one.
+
+  Reclamation is safe without hazard pointers: a producer stops touching a node once it has linked
+  the next one, and a consumer retires a node only after it saw that link. Retired nodes are handed
+  back to the producers Batch at a time through a third lock, which is also the only one that guards
+  the ObjectAllocator, so the pool is used single-threaded and is only called when the recycled
+  nodes run out. At most Capacity values are queued; TryPush fails instead of growing past it.
+*/
+template <typename T>
+class PoolQueue
+{
+  public:
+    static const unsigned DEFAULT_BATCH = 32; //!< nodes moved between consumers and producers at once
+
+      // Creates an empty queue that holds at most Capacity values
+      // Throws an exception if the first node can't be allocated
+    explicit PoolQueue(size_t Capacity, unsigned Batch = DEFAULT_BATCH)
+        : head_{nullptr}, retired_{nullptr}, retiredTail_{nullptr}, retiredCount_{0}, tail_{nullptr},
+          spare_{nullptr}, returned_{nullptr}, pool_{sizeof(Node), Config(Batch)}, size_{0},
+          capacity_{Capacity}, batch_{Batch ? Batch : 1}
+    {
+      head_ = tail_ = NewNode();
+    }
+
+      // Destroys the values still queued, the pool releases the nodes
+    ~PoolQueue()
+    {
+      for (Node *node = head_->next_.load(std::memory_order_relaxed); node; node = node->next_.load(std::memory_order_relaxed))
+        node->Value()->~T();
+    }
+
+      // Constructs a value at the tail from args, false if the queue is full
+      // Throws an exception if a node can't be allocated, or what T's constructor throws
+    template <typename... Args>
+    bool TryEmplace(Args &&... args)
+    {
+      if (size_.fetch_add(1, std::memory_order_relaxed) >= capacity_)
+      {
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      std::lock_guard<std::mutex> lock(tailLock_);
+      Node *node;
+      try
+      {
+        node = spare_ ? spare_ : Refill();
+        new (node->value_) T(std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        throw;
+      }
+      spare_ = node->next_.load(std::memory_order_relaxed);
+      node->next_.store(nullptr, std::memory_order_relaxed);
+      tail_->next_.store(node, std::memory_order_release); //publishes the value to the consumers
+      tail_ = node;
+      return true;
+    }
+
+      // Copies or moves value to the tail, false if the queue is full
+    bool TryPush(const T &value) { return TryEmplace(value); }
+    bool TryPush(T &&value) { return TryEmplace(std::move(value)); }
+
+      // Moves the value at the head into value, false if the queue is empty
+    bool TryPop(T &value)
+    {
+      Node *batch = nullptr, *batchTail = nullptr;
+      {
+        std::lock_guard<std::mutex> lock(headLock_);
+        Node *next = head_->next_.load(std::memory_order_acquire);
+        if (!next)
+          return false;
+        T *stored = next->Value();
+        value = std::move(*stored);
+        stored->~T();
+
+        Node *old = head_; //next is the new dummy, the producers are done with old
+        head_ = next;
+        old->next_.store(retired_, std::memory_order_relaxed);
+        if (!retired_)
+          retiredTail_ = old;
+        retired_ = old;
+        if (++retiredCount_ >= batch_)
+        {
+          batch = retired_;
+          batchTail = retiredTail_;
+          retired_ = retiredTail_ = nullptr;
+          retiredCount_ = 0;
+        }
+      }
+      size_.fetch_sub(1, std::memory_order_relaxed);
+
+      if (batch) //hand the batch to the producers in O(1)
+      {
+        std::lock_guard<std::mutex> lock(poolLock_);
+        batchTail->next_.store(returned_, std::memory_order_relaxed);
+        returned_ = batch;
+      }
+      return true;
+    }
+
+    size_t Size() const { return size_.load(std::memory_order_relaxed); } // values queued (approximate while in use)
+    size_t Capacity() const { return capacity_; }                         // most values queued at once
+
+      // Statistics of the node pool
+    OAStats GetStats() const
+    {
+      std::lock_guard<std::mutex> lock(poolLock_);
+      return pool_.GetStats();
+    }
+
+      // Prevent copy construction and assignment
+    PoolQueue(const PoolQueue &) = delete;            //!< Do not implement!
+    PoolQueue &operator=(const PoolQueue &) = delete; //!< Do not implement!
+
+  private:
+    /*!
+      A value and the link to the next node (also the link of the spare/retired chains)
+    */
+    struct Node
+    {
+      std::atomic<Node *> next_;                //!< next node towards the tail
+      alignas(T) unsigned char value_[sizeof(T)]; //!< the value, constructed in place
+
+      T *Value() { return std::launder(reinterpret_cast<T *>(value_)); }
+    };
+
+      // Pool configuration, Batch nodes per page, aligned for Node
+    static OAConfig Config(unsigned Batch)
+    {
+      OAConfig config(false, Batch ? Batch : 1, 0, false, 0, OAConfig::HeaderBlockInfo(),
+                      alignof(Node) > alignof(GenericObject) ? alignof(Node) : alignof(GenericObject));
+      if (alignof(Node) > alignof(std::max_align_t)) //over-aligned T, the pages must be aligned too
+        config.IOAlignment_ = alignof(Node);
+      return config;
+    }
+
+      // A node from the pool, poolLock_ must be held (or the queue not shared yet)
+    Node *NewNode()
+    {
+      Node *node = static_cast<Node *>(pool_.Allocate());
+      new (&node->next_) std::atomic<Node *>(nullptr);
+      return node;
+    }
+
+      // Fills spare_ with the retired nodes, or Batch new nodes if there are none (tailLock_ held)
+    Node *Refill()
+    {
+      std::lock_guard<std::mutex> lock(poolLock_);
+      if (returned_)
+      {
+        spare_ = returned_;
+        returned_ = nullptr;
+        return spare_;
+      }
+      for (unsigned i = 0; i < batch_; ++i)
+      {
+        try
+        {
+          Node *node = NewNode();
+          node->next_.store(spare_, std::memory_order_relaxed);
+          spare_ = node;
+        }
+        catch (OAException &)
+        {
+          if (!spare_)
+            throw;
+          break; //got some
+        }
+      }
+      return spare_;
+    }
+
+    alignas(64) std::mutex headLock_;  // consumers
+    Node *head_;                       // dummy node, the values follow it
+    Node *retired_;                    // popped nodes not handed back yet
+    Node *retiredTail_;
+    unsigned retiredCount_;
+
+    alignas(64) std::mutex tailLock_;  // producers
+    Node *tail_;                       // last node
+    Node *spare_;                      // recycled or new nodes ready for pushing
+
+    alignas(64) mutable std::mutex poolLock_; // guards returned_ and pool_
+    Node *returned_;                   // batches of retired nodes waiting for the producers
+    ObjectAllocator pool_;             // the memory of every node
+
+    alignas(64) std::atomic<size_t> size_; // values queued or being pushed
+    size_t capacity_;
+    unsigned batch_;
+};
+
+template <typename T>
+const unsigned PoolQueue<T>::DEFAULT_BATCH;
+
+#endif
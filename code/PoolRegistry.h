@@ -0,0 +1,125 @@
+/**
+ * @file PoolRegistry.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides PoolRegistry, a facade over ObjectAllocator that lazily creates one pool
+ * per object type. The configuration of each pool is chosen by specialising PoolTraits.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef POOLREGISTRYH
+#define POOLREGISTRYH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <cstddef> // std::max_align_t
+#include <new>     // placement new
+#include <utility> // std::forward
+
+/*!
+  Configuration used for the pool of objects of type T.
+
+  Specialise this template to tune the pool of a particular type, e.g.
+
+    template <>
+    struct PoolTraits<Employee>
+    {
+      static OAConfig Config() { return OAConfig(false, 64, 0); }
+      static const char *Label() { return "Employee"; }
+    };
+
+  The default is an unlimited pool of DEFAULT_OBJECTS_PER_PAGE objects per page, aligned for T.
+*/
+template <typename T>
+struct PoolTraits
+{
+  /*!
+    Returns the configuration of the pool for T.
+  */
+  static OAConfig Config()
+  {
+    OAConfig config(false, DEFAULT_OBJECTS_PER_PAGE, 0, false, 0, OAConfig::HeaderBlockInfo(),
+                    alignof(T) > alignof(GenericObject) ? alignof(T) : alignof(GenericObject));
+    if (alignof(T) > alignof(std::max_align_t)) //over-aligned T, the pages must be aligned too
+      config.IOAlignment_ = alignof(T);
+    return config;
+  }
+
+  /*!
+    Returns the label passed to ObjectAllocator::Allocate for every object of type T.
+  */
+  static const char *Label() { return nullptr; }
+};
+
+/*!
+  Facade that gives every type its own ObjectAllocator.
+
+  Each pool is a function-local static inside Pool<T>, so the lookup is resolved at compile time
+  and the pool is created on first use. The pools themselves are as thread-safe as ObjectAllocator
+  (i.e. not at all); only their creation is.
+*/
+class PoolRegistry
+{
+  public:
+      // Size of the blocks handed out for T (a block must be able to hold a free list link)
+    template <typename T>
+    static constexpr size_t BlockSize()
+    {
+      return sizeof(T) > sizeof(GenericObject) ? sizeof(T) : sizeof(GenericObject);
+    }
+
+      // Returns the pool that serves objects of type T, creating it on first use
+    template <typename T>
+    static ObjectAllocator &Pool()
+    {
+      static ObjectAllocator pool(BlockSize<T>(), PoolTraits<T>::Config());
+      return pool;
+    }
+
+      // Raw memory for one T (no constructor is called)
+    template <typename T>
+    static void *Allocate()
+    {
+      return Pool<T>().Allocate(PoolTraits<T>::Label());
+    }
+
+      // Returns raw memory obtained with Allocate<T> (no destructor is called)
+    template <typename T>
+    static void Free(void *Object)
+    {
+      Pool<T>().Free(Object);
+    }
+
+      // Allocates and constructs a T from args (simulates new)
+    template <typename T, typename... Args>
+    static T *New(Args &&... args)
+    {
+      void *mem = Allocate<T>();
+      try
+      {
+        return new (mem) T(std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        Free<T>(mem); // constructor threw, give the block back
+        throw;
+      }
+    }
+
+      // Destroys and frees an object created with New<T> (simulates delete)
+    template <typename T>
+    static void Delete(T *Object)
+    {
+      if (!Object)
+        return;
+      Object->~T();
+      Free<T>(Object);
+    }
+};
+
+#endif
@@ -0,0 +1,268 @@
+/**
+ * @file PoolSkipList.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides PoolSkipList, an ordered map implemented as a skip list whose nodes come
+ * from one ObjectAllocator per node height.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef POOLSKIPLISTH
+#define POOLSKIPLISTH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <cstddef>    // std::max_align_t
+#include <functional> // std::less
+#include <new>        // placement new
+#include <utility>    // std::forward, std::pair
+
+/*!
+  Ordered map as a skip list: a node of height h is on the h lowest levels, and each level skips
+  about 3 of every 4 nodes of the level below (p = 1/4), so searches are O(log n) on average.
+
+  A node is its key, its value and then its h links, so its size depends on its height. Each height
+  has its own pool, created on first use, instead of giving every node the links of the tallest one;
+  the pools of taller nodes have smaller pages because those nodes are rarer. Not thread-safe, like
+  ObjectAllocator.
+*/
+template <typename K, typename V, typename Less = std::less<K>>
+class PoolSkipList
+{
+  public:
+    static const unsigned MAX_HEIGHT = 16;              //!< levels, enough for about 4^16 entries
+    static const unsigned DEFAULT_NODES_PER_PAGE = 256; //!< nodes in each page of the height 1 pool
+    static const unsigned MIN_NODES_PER_PAGE = 4;       //!< nodes in each page of the tallest pools
+
+      // Creates an empty map, the pool of nodes of height 1 has NodesPerPage nodes per page
+    explicit PoolSkipList(unsigned NodesPerPage = DEFAULT_NODES_PER_PAGE)
+        : height_(1), size_(0), nodesPerPage_(NodesPerPage), random_(0x9E3779B97F4A7C15ull)
+    {
+      for (unsigned level = 0; level < MAX_HEIGHT; ++level)
+      {
+        head_[level] = nullptr;
+        pools_[level] = nullptr;
+      }
+    }
+
+      // Destroys the keys and values and the pools
+    ~PoolSkipList()
+    {
+      Clear();
+      for (ObjectAllocator *pool : pools_)
+        delete pool;
+    }
+
+      // Inserts key and a value constructed from args if key is absent
+      // Returns the value of key and whether it was inserted
+      // Throws an exception if the node can't be allocated
+    template <typename... Args>
+    std::pair<V *, bool> Emplace(const K &key, Args &&... args)
+    {
+      Node **update[MAX_HEIGHT];
+      Node *found = Search(key, update);
+      if (found)
+        return std::pair<V *, bool>(&found->value_, false);
+
+      unsigned height = RandomHeight();
+      ObjectAllocator &pool = Pool(height);
+      void *memory = pool.Allocate();
+      Node *node;
+      try
+      {
+        node = new (memory) Node(key, height, std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        pool.Free(memory);
+        throw;
+      }
+      for (; height_ < height; ++height_)
+        update[height_] = head_;
+      Node **links = Links(node);
+      for (unsigned level = 0; level < height; ++level)
+      {
+        links[level] = update[level][level];
+        update[level][level] = node;
+      }
+      ++size_;
+      return std::pair<V *, bool>(&node->value_, true);
+    }
+
+      // Inserts a copy of value if key is absent
+    std::pair<V *, bool> Insert(const K &key, const V &value) { return Emplace(key, value); }
+
+      // Value of key, null if absent
+    V *Find(const K &key)
+    {
+      Node *node = LowerBound(key);
+      return node && !less_(key, node->key_) ? &node->value_ : nullptr;
+    }
+
+      // Removes key, false if it was absent
+    bool Erase(const K &key)
+    {
+      Node **update[MAX_HEIGHT];
+      Node *node = Search(key, update);
+      if (!node)
+        return false;
+
+      Node **links = Links(node);
+      for (unsigned level = 0; level < node->height_; ++level)
+        update[level][level] = links[level];
+      while (height_ > 1 && !head_[height_ - 1])
+        --height_;
+      Destroy(node);
+      --size_;
+      return true;
+    }
+
+      // Calls fn(key, value) for each entry, in key order
+    template <typename Fn>
+    void ForEach(Fn fn)
+    {
+      for (Node *node = head_[0]; node; node = Links(node)[0])
+        fn(static_cast<const K &>(node->key_), node->value_);
+    }
+
+      // Calls fn(key, value) for each entry with first <= key < last, in key order
+    template <typename Fn>
+    void ForEachInRange(const K &first, const K &last, Fn fn)
+    {
+      for (Node *node = LowerBound(first); node && less_(node->key_, last); node = Links(node)[0])
+        fn(static_cast<const K &>(node->key_), node->value_);
+    }
+
+      // Removes every entry
+    void Clear()
+    {
+      Node *node = head_[0];
+      while (node)
+      {
+        Node *next = Links(node)[0];
+        Destroy(node);
+        node = next;
+      }
+      for (Node *&head : head_)
+        head = nullptr;
+      height_ = 1;
+      size_ = 0;
+    }
+
+    size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+
+      // Statistics of the pool of nodes of height (1 to MAX_HEIGHT), all zeros if it wasn't needed yet
+    OAStats GetStats(unsigned height) const
+    {
+      return height && height <= MAX_HEIGHT && pools_[height - 1] ? pools_[height - 1]->GetStats() : OAStats();
+    }
+
+      // Prevent copy construction and assignment
+    PoolSkipList(const PoolSkipList &) = delete;            //!< Do not implement!
+    PoolSkipList &operator=(const PoolSkipList &) = delete; //!< Do not implement!
+
+  private:
+    /*!
+      An entry, its height_ links follow it at LINKS_OFFSET
+    */
+    struct Node
+    {
+      template <typename... Args>
+      Node(const K &key, unsigned height, Args &&... args)
+          : key_(key), value_(std::forward<Args>(args)...), height_(height) {}
+
+      K key_;           //!< the key
+      V value_;         //!< the value
+      unsigned height_; //!< number of links, also selects the pool
+    };
+
+    static const size_t LINKS_OFFSET = (sizeof(Node) + alignof(Node *) - 1) / alignof(Node *) * alignof(Node *); //!< links after the node
+    static const size_t NODE_ALIGNMENT = alignof(Node) > alignof(GenericObject) ? alignof(Node) : alignof(GenericObject); //!< alignment of a block
+
+    static Node **Links(Node *node) { return reinterpret_cast<Node **>(reinterpret_cast<unsigned char *>(node) + LINKS_OFFSET); }
+
+      // The pool of nodes of height, created on first use
+    ObjectAllocator &Pool(unsigned height)
+    {
+      ObjectAllocator *&pool = pools_[height - 1];
+      if (!pool)
+      {
+        unsigned shift = 2 * (height - 1); //a height is 4 times rarer than the one below
+        unsigned perPage = shift < 32 ? nodesPerPage_ >> shift : 0;
+        OAConfig config(false, perPage > MIN_NODES_PER_PAGE ? perPage : MIN_NODES_PER_PAGE, 0, false, 0,
+                        OAConfig::HeaderBlockInfo(), NODE_ALIGNMENT);
+        if (NODE_ALIGNMENT > alignof(std::max_align_t)) //over-aligned K or V, the pages must be aligned too
+          config.IOAlignment_ = NODE_ALIGNMENT;
+        pool = new ObjectAllocator(LINKS_OFFSET + height * sizeof(Node *), config);
+      }
+      return *pool;
+    }
+
+      // Destroys node and gives it back to its pool
+    void Destroy(Node *node)
+    {
+      ObjectAllocator *pool = pools_[node->height_ - 1];
+      node->~Node();
+      pool->Free(node);
+    }
+
+      // Height of a new node, 1 + the number of times a 1/4 chance came up
+    unsigned RandomHeight()
+    {
+      random_ ^= random_ << 13; //xorshift64
+      random_ ^= random_ >> 7;
+      random_ ^= random_ << 17;
+      unsigned height = 1;
+      for (unsigned long long bits = random_; height < MAX_HEIGHT && (bits & 3) == 0; bits >>= 2)
+        ++height;
+      return height;
+    }
+
+      // First node whose key isn't less than key, null if none
+    Node *LowerBound(const K &key)
+    {
+      Node **links = head_;
+      for (unsigned level = height_; level-- > 0;)
+        while (links[level] && less_(links[level]->key_, key))
+          links = Links(links[level]);
+      return links[0];
+    }
+
+      // Like LowerBound, also records in update the links that point past key on each level
+      // Returns the node of key, null if absent
+    Node *Search(const K &key, Node **update[MAX_HEIGHT])
+    {
+      Node **links = head_;
+      for (unsigned level = height_; level-- > 0;)
+      {
+        while (links[level] && less_(links[level]->key_, key))
+          links = Links(links[level]);
+        update[level] = links;
+      }
+      Node *node = links[0];
+      return node && !less_(key, node->key_) ? node : nullptr;
+    }
+
+    Node *head_[MAX_HEIGHT];             // first node of each level
+    ObjectAllocator *pools_[MAX_HEIGHT]; // nodes of each height, null until needed
+    unsigned height_;                    // levels in use
+    size_t size_;                        // entries
+    unsigned nodesPerPage_;              // page size of the height 1 pool
+    unsigned long long random_;          // state of RandomHeight
+    Less less_;
+};
+
+template <typename K, typename V, typename Less>
+const unsigned PoolSkipList<K, V, Less>::MAX_HEIGHT;
+template <typename K, typename V, typename Less>
+const unsigned PoolSkipList<K, V, Less>::DEFAULT_NODES_PER_PAGE;
+template <typename K, typename V, typename Less>
+const unsigned PoolSkipList<K, V, Less>::MIN_NODES_PER_PAGE;
+
+#endif
@@ -0,0 +1,337 @@
+/**
+ * @file StripedObjectAllocator.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file implements StripedObjectAllocator, the pool with a lock and free list per page.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "StripedObjectAllocator.h"
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <thread>
+
+const size_t StripedObjectAllocator::CACHE_LINE;
+
+/**
+ * @brief Rounds up to a multiple
+ *
+ * @param size Size to round
+ * @param multiple Multiple to round to
+ * @return size_t Rounded size
+ */
+static size_t RoundUp(size_t size, size_t multiple)
+{
+    return (size + multiple - 1) / multiple * multiple;
+}
+
+/**
+ * @brief Construct a new StripedObjectAllocator
+ *
+ * @param ObjectSize size of each object
+ * @param config configuration, see the class comment for the fields used
+ * @param Stripes number of stripes, 0 for twice the hardware threads
+ * @exception OAException E_NO_MEMORY No memory for the stripes
+ */
+StripedObjectAllocator::StripedObjectAllocator(size_t ObjectSize, const OAConfig &config, unsigned Stripes)
+    : configuration{config}, objectSize_{ObjectSize}, cursor_{0}, retiredAllocations_{0}, retiredDeallocations_{0},
+      mostObjects_{0}
+{
+    size_t alignment = config.Alignment_ > sizeof(void *) ? config.Alignment_ : sizeof(void *);
+    stride_ = RoundUp(ObjectSize < sizeof(void *) ? sizeof(void *) : ObjectSize, alignment);
+    firstObject_ = RoundUp(sizeof(PageHeader), alignment);
+    size_t wanted = config.PageBytes_ ? config.PageBytes_ : firstObject_ + stride_ * (config.ObjectsPerPage_ ? config.ObjectsPerPage_ : 1);
+    pageBytes_ = 4096;
+    while (pageBytes_ < wanted) //power of two, so a block finds its page with a mask
+        pageBytes_ *= 2;
+    objects_ = static_cast<unsigned>((pageBytes_ - firstObject_) / stride_);
+    configuration.ObjectsPerPage_ = objects_;
+    configuration.PageBytes_ = pageBytes_;
+    configuration.PadBytes_ = 0;
+
+    if (!Stripes)
+        Stripes = 2 * (std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4);
+    try
+    {
+        stripes_ = std::vector<Stripe>(Stripes);
+    }
+    catch (std::bad_alloc &)
+    {
+        throw OAException(OAException::E_NO_MEMORY, "Stripes: No memory available.");
+    }
+    for (Stripe &stripe : stripes_)
+        stripe.page_ = nullptr;
+}
+
+/**
+ * @brief Destroy the StripedObjectAllocator, frees every page
+ *
+ */
+StripedObjectAllocator::~StripedObjectAllocator()
+{
+    for (PageHeader *page : pages_)
+    {
+        page->~PageHeader();
+        ::operator delete(page, std::align_val_t(pageBytes_));
+    }
+}
+
+/**
+ * @brief The stripe of the calling thread, from a hash of its id computed once per thread
+ *
+ * @return Stripe& The stripe
+ */
+StripedObjectAllocator::Stripe &StripedObjectAllocator::ThreadStripe()
+{
+    static thread_local size_t hash = std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9E3779B97F4A7C15ull;
+    return stripes_[(hash >> 32) % stripes_.size()];
+}
+
+/**
+ * @brief Allocates an object. Takes the stripe lock and the lock of the stripe's page.
+ *
+ * @param label Ignored
+ * @return void* The object
+ * @exception OAException E_NO_PAGES MaxPages_ reached and every page is full
+ * @exception OAException E_NO_MEMORY No memory
+ */
+void *StripedObjectAllocator::Allocate(const char *label)
+{
+    (void)label;
+    Stripe &stripe = ThreadStripe();
+    std::lock_guard<std::mutex> stripeLock(stripe.lock_);
+    for (;;)
+    {
+        PageHeader *page = stripe.page_;
+        if (page)
+        {
+            std::lock_guard<std::mutex> pageLock(page->lock_);
+            GenericObject *block = page->free_;
+            if (block)
+            {
+                page->free_ = block->Next;
+                --page->freeCount_;
+                ++page->allocations_;
+                return block;
+            }
+        }
+        Refill(stripe);
+    }
+}
+
+/**
+ * @brief Points a stripe at a page with free blocks: one no other stripe uses if possible, then any
+ *  page with free blocks, then a new page
+ *
+ * @param stripe Stripe whose page ran out, its lock held
+ * @exception OAException E_NO_PAGES MaxPages_ reached and every page is full
+ * @exception OAException E_NO_MEMORY No memory
+ */
+void StripedObjectAllocator::Refill(Stripe &stripe)
+{
+    std::lock_guard<std::mutex> lock(globalLock_);
+    PageHeader *chosen = nullptr, *shared = nullptr;
+    for (size_t n = 0; n < pages_.size() && !chosen; ++n)
+    {
+        PageHeader *page = pages_[(cursor_ + n) % pages_.size()];
+        if (page == stripe.page_)
+            continue;
+        std::lock_guard<std::mutex> pageLock(page->lock_);
+        if (!page->freeCount_)
+            continue;
+        if (!page->stripes_)
+        {
+            chosen = page;
+            cursor_ = (cursor_ + n + 1) % pages_.size();
+        }
+        else if (!shared)
+            shared = page;
+    }
+    if (!chosen)
+        chosen = shared;
+    if (!chosen)
+        chosen = NewPage();
+
+    if (stripe.page_)
+        --stripe.page_->stripes_;
+    ++chosen->stripes_;
+    stripe.page_ = chosen;
+}
+
+/**
+ * @brief Creates a page with all its blocks on its free list
+ *
+ * @return PageHeader* The page
+ * @exception OAException E_NO_PAGES MaxPages_ reached
+ * @exception OAException E_NO_MEMORY No memory
+ */
+StripedObjectAllocator::PageHeader *StripedObjectAllocator::NewPage()
+{
+    if (configuration.MaxPages_ && pages_.size() >= configuration.MaxPages_)
+        throw OAException(OAException::E_NO_PAGES, "Exceeded max pages!");
+    unsigned char *memory;
+    try
+    {
+        memory = static_cast<unsigned char *>(::operator new(pageBytes_, std::align_val_t(pageBytes_)));
+        pages_.reserve(pages_.size() + 1);
+    }
+    catch (std::bad_alloc &)
+    {
+        throw OAException(OAException::E_NO_MEMORY, "Out of memory!");
+    }
+
+    PageHeader *page = new (memory) PageHeader;
+    page->free_ = nullptr;
+    for (unsigned i = objects_; i-- > 0;) //lowest address first on the free list
+    {
+        GenericObject *block = reinterpret_cast<GenericObject *>(memory + firstObject_ + i * stride_);
+        block->Next = page->free_;
+        page->free_ = block;
+    }
+    page->freeCount_ = objects_;
+    page->allocations_ = 0;
+    page->deallocations_ = 0;
+    page->stripes_ = 0;
+    pages_.push_back(page);
+    return page;
+}
+
+/**
+ * @brief Finds the page of a block from its address
+ *
+ * @param Object The block
+ * @return PageHeader* Its page
+ */
+StripedObjectAllocator::PageHeader *StripedObjectAllocator::PageOf(const void *Object) const
+{
+    return reinterpret_cast<PageHeader *>(reinterpret_cast<size_t>(Object) & ~(pageBytes_ - 1));
+}
+
+/**
+ * @brief DebugOn_ checks of a block given to Free
+ *
+ * @param page Page of the block, its lock held
+ * @param Object The block
+ * @exception OAException E_BAD_BOUNDARY Not at the start of a block
+ * @exception OAException E_MULTIPLE_FREE Already on the free list
+ */
+void StripedObjectAllocator::CheckBlock(PageHeader *page, const void *Object) const
+{
+    size_t offset = static_cast<size_t>(static_cast<const unsigned char *>(Object) - reinterpret_cast<unsigned char *>(page));
+    if (offset < firstObject_ || (offset - firstObject_) % stride_ || (offset - firstObject_) / stride_ >= objects_)
+        throw OAException(OAException::E_BAD_BOUNDARY, "BAD BOUNDARY");
+    for (GenericObject *block = page->free_; block; block = block->Next)
+        if (block == Object)
+            throw OAException(OAException::E_MULTIPLE_FREE, "Multiple free!");
+}
+
+/**
+ * @brief Returns an object to its page, only the page lock is taken
+ *
+ * @param Object Object to free
+ * @exception OAException E_BAD_BOUNDARY, E_MULTIPLE_FREE DebugOn_ checks failed
+ */
+void StripedObjectAllocator::Free(void *Object)
+{
+    PageHeader *page = PageOf(Object);
+    if (configuration.DebugOn_)
+    {
+        std::lock_guard<std::mutex> lock(globalLock_); //the page must be one of ours before its lock is used
+        if (std::find(pages_.begin(), pages_.end(), page) == pages_.end())
+            throw OAException(OAException::E_BAD_BOUNDARY, "OUT OF PAGE BOUNDARY");
+    }
+    std::lock_guard<std::mutex> lock(page->lock_);
+    if (configuration.DebugOn_)
+        CheckBlock(page, Object);
+    GenericObject *block = static_cast<GenericObject *>(Object);
+    block->Next = page->free_;
+    page->free_ = block;
+    ++page->freeCount_;
+    ++page->deallocations_;
+}
+
+/**
+ * @brief Frees the pages whose blocks are all free and that no stripe is using
+ *
+ * @return unsigned Number of pages freed
+ */
+unsigned StripedObjectAllocator::FreeEmptyPages()
+{
+    std::lock_guard<std::mutex> lock(globalLock_);
+    unsigned freed = 0;
+    std::vector<PageHeader *>::iterator keep = pages_.begin();
+    for (PageHeader *page : pages_)
+    {
+        bool empty;
+        {
+            std::lock_guard<std::mutex> pageLock(page->lock_);
+            empty = !page->stripes_ && page->freeCount_ == objects_;
+        }
+        if (!empty)
+        {
+            *keep++ = page;
+            continue;
+        }
+        retiredAllocations_ += page->allocations_;
+        retiredDeallocations_ += page->deallocations_;
+        page->~PageHeader();
+        ::operator delete(page, std::align_val_t(pageBytes_));
+        ++freed;
+    }
+    pages_.erase(keep, pages_.end());
+    cursor_ = 0;
+    return freed;
+}
+
+/**
+ * @brief Get the configuration, ObjectsPerPage_ and PageBytes_ are the values in use
+ *
+ * @return OAConfig The configuration
+ */
+OAConfig StripedObjectAllocator::GetConfig() const
+{
+    return configuration;
+}
+
+/**
+ * @brief Sums the counters of every page
+ *
+ * @return OAStats The statistics
+ */
+OAStats StripedObjectAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(globalLock_);
+    OAStats stats;
+    stats.ObjectSize_ = objectSize_;
+    stats.PageSize_ = pageBytes_;
+    stats.PagesInUse_ = static_cast<unsigned>(pages_.size());
+    stats.Allocations_ = retiredAllocations_;
+    stats.Deallocations_ = retiredDeallocations_;
+    for (PageHeader *page : pages_)
+    {
+        std::lock_guard<std::mutex> pageLock(page->lock_);
+        stats.FreeObjects_ += page->freeCount_;
+        stats.Allocations_ += page->allocations_;
+        stats.Deallocations_ += page->deallocations_;
+    }
+    stats.ObjectsInUse_ = stats.PagesInUse_ * objects_ - stats.FreeObjects_;
+    if (stats.ObjectsInUse_ > mostObjects_)
+        mostObjects_ = stats.ObjectsInUse_;
+    stats.MostObjects_ = mostObjects_;
+    return stats;
+}
+
+/**
+ * @brief Number of stripes
+ *
+ * @return unsigned Count
+ */
+unsigned StripedObjectAllocator::Stripes() const
+{
+    return static_cast<unsigned>(stripes_.size());
+}
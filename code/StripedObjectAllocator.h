@@ -0,0 +1,103 @@
+/**
+ * @file StripedObjectAllocator.h
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief This file provides the interface of StripedObjectAllocator, a thread-safe pool where each
+ * page has its own lock and free list, and threads are spread over the pages by their id.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef STRIPEDOBJECTALLOCATORH
+#define STRIPEDOBJECTALLOCATORH
+//---------------------------------------------------------------------------
+
+#include "ObjectAllocator.h"
+#include <mutex>
+#include <vector>
+
+/*!
+  Concurrent pool for objects that rarely move between threads. Each thread hashes to a stripe, each
+  stripe allocates from its own page, so concurrent Allocate calls mostly lock different pages.
+  Pages are aligned on their (power of two) size, Free finds the page of a block with a mask and
+  only locks that page. The global lock is taken when a stripe's page runs out, to pick another
+  page or create one, and by FreeEmptyPages.
+
+  Uses ObjectsPerPage_ or PageBytes_ (rounded up to a power of two), Alignment_, MaxPages_ and
+  DebugOn_ (boundary and double free checks, no signatures) of OAConfig.
+*/
+class StripedObjectAllocator
+{
+  public:
+    static const size_t CACHE_LINE = 64; //!< stripes are this far apart
+
+      // Creates the pool (Stripes=0: twice the hardware threads), no page yet
+    StripedObjectAllocator(size_t ObjectSize, const OAConfig &config, unsigned Stripes = 0);
+    ~StripedObjectAllocator();
+
+      // Take an object from the page of the calling thread's stripe
+    void *Allocate(const char *label = 0);
+
+      // Returns an object to its page
+    void Free(void *Object);
+
+      // Frees the empty pages no stripe is using
+    unsigned FreeEmptyPages();
+
+    OAConfig GetConfig() const;   // returns the configuration parameters
+    OAStats GetStats() const;     // sums the counters of every page (MostObjects_ is the most seen by GetStats)
+    unsigned Stripes() const;     // number of stripes
+
+      // Prevent copy construction and assignment
+    StripedObjectAllocator(const StripedObjectAllocator &) = delete;            //!< Do not implement!
+    StripedObjectAllocator &operator=(const StripedObjectAllocator &) = delete; //!< Do not implement!
+
+  private:
+    /*!
+      Header at the start of each page
+    */
+    struct PageHeader
+    {
+      std::mutex lock_;         //!< guards the fields below
+      GenericObject *free_;     //!< free list of the page
+      unsigned freeCount_;      //!< blocks on it
+      unsigned allocations_;    //!< Allocate calls served by the page
+      unsigned deallocations_;  //!< Free calls on the page
+      unsigned stripes_;        //!< stripes using the page (global lock)
+    };
+
+    /*!
+      What one group of threads allocates from, on its own cache line
+    */
+    struct alignas(CACHE_LINE) Stripe
+    {
+      std::mutex lock_;   //!< held while allocating, and while page_ is replaced
+      PageHeader *page_;  //!< page the stripe allocates from (null before the first allocation)
+    };
+
+    OAConfig configuration;                // configuration parameters
+    size_t objectSize_;                    // size of each object
+    size_t stride_;                        // distance between objects
+    size_t firstObject_;                   // offset of the first object in a page
+    size_t pageBytes_;                     // size and alignment of a page
+    unsigned objects_;                     // objects per page
+    std::vector<Stripe> stripes_;          // one per group of threads
+    mutable std::mutex globalLock_;        // guards pages_, PageHeader::stripes_ and the counters below
+    std::vector<PageHeader *> pages_;      // every page
+    size_t cursor_;                        // where the search for a page with free blocks resumes
+    unsigned retiredAllocations_;          // counters of the pages already released
+    unsigned retiredDeallocations_;
+    mutable unsigned mostObjects_;         // most objects in use seen by GetStats
+
+    Stripe &ThreadStripe();                // stripe of the calling thread
+    void Refill(Stripe &stripe);           // gives the stripe a page with free blocks (global lock)
+    PageHeader *NewPage();                 // creates a page (global lock held)
+    PageHeader *PageOf(const void *Object) const; // page of a block, by its address
+    void CheckBlock(PageHeader *page, const void *Object) const; // debug checks, page lock held
+};
+
+#endif
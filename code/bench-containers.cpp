@@ -0,0 +1,269 @@
+/**
+ * @file bench-containers.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief Benchmark of the pool-backed containers against the standard ones: IntrusiveList (objects
+ * from PoolRegistry) against std::list, PoolHashMap against std::unordered_map and PoolSkipList against
+ * std::map. Prints millions of operations per second for insert, find, iteration and erase.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "IntrusiveList.h"
+#include "PoolHashMap.h"
+#include "PoolRegistry.h"
+#include "PoolSkipList.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+static const unsigned DEFAULT_ENTRIES = 200000; // entries inserted by each run
+static const unsigned ROUNDS = 5;               // best of this many runs is printed
+
+/*!
+  Element of the lists, about the size of the driver's Employee
+*/
+struct Item : ListHook<>
+{
+    explicit Item(unsigned key) : key_(key), salary_(0) {}
+
+    unsigned key_;        //!< identifies the item
+    double salary_;       //!< payload
+    char name_[32];       //!< payload
+};
+
+/*!
+  Operations per second of each phase
+*/
+struct Rates
+{
+    double insert_;  //!< entries inserted per second
+    double find_;    //!< lookups per second (lists: 0)
+    double iterate_; //!< entries visited per second
+    double erase_;   //!< entries erased per second
+};
+
+static volatile unsigned long long sink; // keeps the loops from being optimised away
+
+/*!
+  Measures one phase
+*/
+class Phase
+{
+  public:
+    explicit Phase(double &rate, size_t operations)
+        : rate_(rate), operations_(operations), start_(std::chrono::steady_clock::now()) {}
+    ~Phase()
+    {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        double rate = static_cast<double>(operations_) / seconds / 1e6;
+        if (rate > rate_)
+            rate_ = rate;
+    }
+
+  private:
+    double &rate_;                                 // best rate so far
+    size_t operations_;                            // operations in the phase
+    std::chrono::steady_clock::time_point start_;  // when the phase started
+};
+
+/**
+ * @brief std::list of Item, erased in random order through saved iterators
+ *
+ * @param keys Keys to insert
+ * @param order Random permutation of the indexes of keys
+ * @param rates Best rates
+ */
+static void RunStdList(const std::vector<unsigned> &keys, const std::vector<unsigned> &order, Rates &rates)
+{
+    std::list<Item> list;
+    std::vector<std::list<Item>::iterator> items(keys.size());
+    {
+        Phase phase(rates.insert_, keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            items[i] = list.emplace(list.end(), keys[i]);
+    }
+    {
+        Phase phase(rates.iterate_, keys.size());
+        unsigned long long sum = 0;
+        for (const Item &item : list)
+            sum += item.key_;
+        sink = sum;
+    }
+    {
+        Phase phase(rates.erase_, keys.size());
+        for (unsigned i : order)
+            list.erase(items[i]);
+    }
+}
+
+/**
+ * @brief IntrusiveList of Items from PoolRegistry, erased in random order through saved pointers
+ *
+ * @param keys Keys to insert
+ * @param order Random permutation of the indexes of keys
+ * @param rates Best rates
+ */
+static void RunIntrusiveList(const std::vector<unsigned> &keys, const std::vector<unsigned> &order, Rates &rates)
+{
+    IntrusiveList<Item> list;
+    std::vector<Item *> items(keys.size());
+    {
+        Phase phase(rates.insert_, keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            items[i] = PoolRegistry::New<Item>(keys[i]);
+            list.PushBack(items[i]);
+        }
+    }
+    {
+        Phase phase(rates.iterate_, keys.size());
+        unsigned long long sum = 0;
+        for (const Item &item : list)
+            sum += item.key_;
+        sink = sum;
+    }
+    {
+        Phase phase(rates.erase_, keys.size());
+        for (unsigned i : order)
+        {
+            list.Remove(items[i]);
+            PoolRegistry::Delete(items[i]);
+        }
+    }
+}
+
+/**
+ * @brief A map (std::unordered_map, std::map) through its standard interface
+ *
+ * @param keys Keys to insert
+ * @param order Random permutation of the indexes of keys
+ * @param rates Best rates
+ */
+template <typename Map>
+static void RunStdMap(const std::vector<unsigned> &keys, const std::vector<unsigned> &order, Rates &rates)
+{
+    Map map;
+    {
+        Phase phase(rates.insert_, keys.size());
+        for (unsigned key : keys)
+            map.emplace(key, key);
+    }
+    {
+        Phase phase(rates.find_, keys.size());
+        unsigned long long sum = 0;
+        for (unsigned i : order)
+            sum += map.find(keys[i])->second;
+        sink = sum;
+    }
+    {
+        Phase phase(rates.iterate_, keys.size());
+        unsigned long long sum = 0;
+        for (const typename Map::value_type &entry : map)
+            sum += entry.second;
+        sink = sum;
+    }
+    {
+        Phase phase(rates.erase_, keys.size());
+        for (unsigned i : order)
+            map.erase(keys[i]);
+    }
+}
+
+/**
+ * @brief A pool map (PoolHashMap, PoolSkipList) through Insert/Find/ForEach/Erase
+ *
+ * @param keys Keys to insert
+ * @param order Random permutation of the indexes of keys
+ * @param rates Best rates
+ */
+template <typename Map>
+static void RunPoolMap(const std::vector<unsigned> &keys, const std::vector<unsigned> &order, Rates &rates)
+{
+    Map map;
+    {
+        Phase phase(rates.insert_, keys.size());
+        for (unsigned key : keys)
+            map.Insert(key, key);
+    }
+    {
+        Phase phase(rates.find_, keys.size());
+        unsigned long long sum = 0;
+        for (unsigned i : order)
+            sum += *map.Find(keys[i]);
+        sink = sum;
+    }
+    {
+        Phase phase(rates.iterate_, keys.size());
+        unsigned long long sum = 0;
+        map.ForEach([&sum](const unsigned &, unsigned &value) { sum += value; });
+        sink = sum;
+    }
+    {
+        Phase phase(rates.erase_, keys.size());
+        for (unsigned i : order)
+            map.Erase(keys[i]);
+    }
+}
+
+/**
+ * @brief Prints the rates of a container
+ *
+ * @param name Container
+ * @param rates Best rates
+ */
+static void Print(const char *name, const Rates &rates)
+{
+    if (rates.find_ > 0)
+        printf("%-20s %10.2f %10.2f %10.2f %10.2f\n", name, rates.insert_, rates.find_, rates.iterate_, rates.erase_);
+    else
+        printf("%-20s %10.2f %10s %10.2f %10.2f\n", name, rates.insert_, "-", rates.iterate_, rates.erase_);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned entries = argc > 1 && atoi(argv[1]) > 0 ? static_cast<unsigned>(atoi(argv[1])) : DEFAULT_ENTRIES;
+
+    std::mt19937 random(12345);
+    std::vector<unsigned> keys(entries), order(entries);
+    for (unsigned i = 0; i < entries; ++i)
+    {
+        keys[i] = static_cast<unsigned>(random()); //duplicates are rare enough not to matter
+        order[i] = i;
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    std::shuffle(keys.begin(), keys.end(), random);
+    order.resize(keys.size());
+    std::shuffle(order.begin(), order.end(), random);
+
+    Rates stdList = {}, intrusiveList = {}, unorderedMap = {}, hashMap = {}, map = {}, skipList = {};
+    for (unsigned round = 0; round < ROUNDS; ++round)
+    {
+        RunStdList(keys, order, stdList);
+        RunIntrusiveList(keys, order, intrusiveList);
+        RunStdMap<std::unordered_map<unsigned, unsigned>>(keys, order, unorderedMap);
+        RunPoolMap<PoolHashMap<unsigned, unsigned>>(keys, order, hashMap);
+        RunStdMap<std::map<unsigned, unsigned>>(keys, order, map);
+        RunPoolMap<PoolSkipList<unsigned, unsigned>>(keys, order, skipList);
+    }
+
+    printf("%u entries, millions of operations per second (best of %u)\n", static_cast<unsigned>(keys.size()), ROUNDS);
+    printf("%-20s %10s %10s %10s %10s\n", "Container", "Insert", "Find", "Iterate", "Erase");
+    Print("std::list", stdList);
+    Print("IntrusiveList", intrusiveList);
+    Print("std::unordered_map", unorderedMap);
+    Print("PoolHashMap", hashMap);
+    Print("std::map", map);
+    Print("PoolSkipList", skipList);
+    return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file bench-footprint.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief Memory footprint benchmark. For a grid of object sizes, OAConfig settings and live-set sizes,
+ * allocates and touches the live set and measures the growth of the resident set (anonymous RSS, from
+ * /proc/self/smaps_rollup or /proc/self/statm), then frees everything (and calls FreeEmptyPages) and
+ * measures what is still resident. Prints resident bytes per live object next to the bytes the pool
+ * itself accounts for, with new/delete as the reference. Each measurement runs in its own process so
+ * it starts from a fresh heap. Linux only.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "ObjectAllocator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const size_t SIZES[] = {16, 64, 256, 1024};           // object sizes
+static const unsigned LIVE_SETS[] = {1000, 10000, 100000};   // live objects
+static const size_t DEFAULT_MAX_BYTES = 256u * 1024 * 1024;  // largest live set measured, in object bytes
+
+/*!
+  A way of allocating the objects
+*/
+struct Setup
+{
+    const char *name_; //!< printed name
+    bool pool_;        //!< ObjectAllocator with config_, otherwise new/delete
+    OAConfig config_;  //!< configuration of the pool
+};
+
+/*!
+  What one measurement found
+*/
+struct Footprint
+{
+    double resident_;     //!< RSS growth per live object, in bytes
+    double accounted_;    //!< pool pages per live object, in bytes (0 for new/delete)
+    double afterFree_;    //!< RSS still above the baseline after freeing everything, in KiB
+};
+
+/**
+ * @brief Resident anonymous memory of this process (heap and pool pages), from smaps_rollup (Linux 4.14+)
+ *  or statm. File-backed pages are left out: a forked child faults in code as it first runs it, which
+ *  would be counted as footprint.
+ *
+ * @return size_t Bytes, 0 if neither file can be read
+ */
+static size_t ResidentBytes()
+{
+    if (FILE *file = fopen("/proc/self/smaps_rollup", "r"))
+    {
+        char line[256];
+        size_t kib = 0;
+        while (fgets(line, sizeof(line), file))
+            if (sscanf(line, "Anonymous: %zu kB", &kib) == 1)
+                break;
+        fclose(file);
+        if (kib)
+            return kib * 1024;
+    }
+    size_t total = 0, resident = 0, shared = 0;
+    if (FILE *file = fopen("/proc/self/statm", "r"))
+    {
+        if (fscanf(file, "%zu %zu %zu", &total, &resident, &shared) != 3)
+            resident = shared = 0;
+        fclose(file);
+    }
+    return (resident - shared) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * @brief Allocates live objects of size bytes the way setup says, writes every byte of them, then frees them
+ *
+ * @param setup Allocator and configuration
+ * @param size Object size
+ * @param live Number of live objects
+ * @return Footprint The measurements
+ */
+static Footprint Measure(const Setup &setup, size_t size, unsigned live)
+{
+    std::vector<void *> objects(live, nullptr); //resident before the baseline, so it isn't counted
+    Footprint footprint = {0, 0, 0};
+    size_t baseline = ResidentBytes();
+
+    if (setup.pool_)
+    {
+        ObjectAllocator pool(size, setup.config_);
+        for (void *&object : objects)
+        {
+            object = pool.Allocate("footprint"); //the label is what an external header stores
+            memset(object, 0x5A, size);
+        }
+        OAStats stats = pool.GetStats();
+        footprint.resident_ = (static_cast<double>(ResidentBytes()) - baseline) / live;
+        footprint.accounted_ = static_cast<double>(stats.PagesInUse_) * stats.PageSize_ / live;
+        for (void *object : objects)
+            pool.Free(object);
+        pool.FreeEmptyPages();
+        footprint.afterFree_ = (static_cast<double>(ResidentBytes()) - baseline) / 1024;
+    }
+    else
+    {
+        for (void *&object : objects)
+        {
+            object = new unsigned char[size];
+            memset(object, 0x5A, size);
+        }
+        footprint.resident_ = (static_cast<double>(ResidentBytes()) - baseline) / live;
+        for (void *object : objects)
+            delete[] static_cast<unsigned char *>(object);
+        footprint.afterFree_ = (static_cast<double>(ResidentBytes()) - baseline) / 1024;
+    }
+    return footprint;
+}
+
+/**
+ * @brief Runs Measure in a child process, so the heap of one measurement doesn't serve the next
+ *
+ * @param setup Allocator and configuration
+ * @param size Object size
+ * @param live Number of live objects
+ * @param footprint The measurements, if the child succeeded
+ * @return true The child reported its measurements
+ */
+static bool MeasureInChild(const Setup &setup, size_t size, unsigned live, Footprint &footprint)
+{
+    int channel[2];
+    if (pipe(channel) != 0)
+        return false;
+    pid_t child = fork();
+    if (child < 0)
+    {
+        close(channel[0]);
+        close(channel[1]);
+        return false;
+    }
+    if (child == 0)
+    {
+        close(channel[0]);
+        Footprint result = Measure(setup, size, live);
+        bool sent = write(channel[1], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+        _exit(sent ? 0 : 1);
+    }
+    close(channel[1]);
+    bool received = read(channel[0], &footprint, sizeof(footprint)) == static_cast<ssize_t>(sizeof(footprint));
+    close(channel[0]);
+    int status = 0;
+    waitpid(child, &status, 0);
+    return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    size_t maxBytes = argc > 1 && atoi(argv[1]) > 0 ? static_cast<size_t>(atoi(argv[1])) * 1024 * 1024 : DEFAULT_MAX_BYTES;
+
+    std::vector<Setup> setups;
+    setups.push_back(Setup{"new/delete", false, OAConfig()});
+    setups.push_back(Setup{"OA 256/page", true, OAConfig(false, 256, 0)});
+    Setup exact = {"OA PageBytes_ 64K", true, OAConfig(false, 256, 0)};
+    exact.config_.PageBytes_ = 64 * 1024;
+    setups.push_back(exact);
+    setups.push_back(Setup{"OA basic header", true, OAConfig(false, 256, 0, false, 0, OAConfig::HeaderBlockInfo(OAConfig::hbBasic))});
+    setups.push_back(Setup{"OA external header", true, OAConfig(false, 256, 0, false, 0, OAConfig::HeaderBlockInfo(OAConfig::hbExternal))});
+    setups.push_back(Setup{"OA debug, 8 pad bytes", true, OAConfig(false, 256, 0, true, 8, OAConfig::HeaderBlockInfo(OAConfig::hbBasic))});
+    Setup checked = {"OA checksums", true, OAConfig(false, 256, 0)};
+    checked.config_.Checksums_ = true;
+    setups.push_back(checked);
+
+    printf("Resident bytes per live object (RSS growth / live objects), pool pages per live object, and RSS left\n");
+    printf("after freeing everything (FreeEmptyPages for the pools). Live sets above %zu MiB are skipped.\n\n",
+           maxBytes / (1024 * 1024));
+    printf("%-22s %6s %8s %12s %12s %14s\n", "Allocator", "Size", "Live", "RSS/object", "Pool/object", "After free KiB");
+    for (size_t size : SIZES)
+    {
+        for (unsigned live : LIVE_SETS)
+        {
+            if (size * live > maxBytes)
+                continue;
+            for (const Setup &setup : setups)
+            {
+                fflush(stdout); //or the child would print our buffer again
+                Footprint footprint;
+                if (!MeasureInChild(setup, size, live, footprint))
+                {
+                    printf("%-22s %6zu %8u %12s\n", setup.name_, size, live, "failed");
+                    continue;
+                }
+                if (setup.pool_)
+                    printf("%-22s %6zu %8u %12.1f %12.1f %14.0f\n", setup.name_, size, live, footprint.resident_,
+                           footprint.accounted_, footprint.afterFree_);
+                else
+                    printf("%-22s %6zu %8u %12.1f %12s %14.0f\n", setup.name_, size, live, footprint.resident_, "-",
+                           footprint.afterFree_);
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,304 @@
+/**
+ * @file bench-io.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief Local file I/O benchmark of the I/O buffer mode (OAConfig::IOAlignment_ and AllocateIov). Each
+ * request gathers chunks from random offsets of an input file and writes them out as one message. Two
+ * std::vector baselines: one message vector reused by every request, each chunk read into its place and
+ * the message written with pwrite, and a vector per chunk written with pwritev. The pool version reads
+ * straight into pool blocks and writes them with pwritev. Prints the time and the calls to operator new
+ * of each.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "ObjectAllocator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static const size_t CHUNK_SIZE = 4096;        // bytes read from one offset, also the alignment for O_DIRECT
+static const unsigned CHUNKS_PER_REQUEST = 16; // chunks gathered into one message
+static const unsigned DEFAULT_REQUESTS = 20000;
+static const unsigned FILE_CHUNKS = 4096;     // size of the input file in chunks (16 MiB)
+static const unsigned OUTPUT_MESSAGES = FILE_CHUNKS / CHUNKS_PER_REQUEST; // messages are written round-robin over this many slots
+
+static unsigned long long newCalls; // calls to operator new, counted by the replacements below
+
+/**
+ * @brief Counting replacement of the global operator new
+ *
+ * @param size Bytes
+ * @return void* Memory
+ * @exception std::bad_alloc No memory
+ */
+void *operator new(size_t size)
+{
+    ++newCalls;
+    if (void *memory = malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief Counting replacement of the global aligned operator new
+ *
+ * @param size Bytes
+ * @param alignment Alignment
+ * @return void* Memory
+ * @exception std::bad_alloc No memory
+ */
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    ++newCalls;
+    size_t align = static_cast<size_t>(alignment);
+    if (void *memory = aligned_alloc(align, (size + align - 1) / align * align))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { free(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept { free(memory); }
+
+/*!
+  What one run cost
+*/
+struct Result
+{
+    double seconds_;              //!< wall time
+    unsigned long long news_;     //!< calls to operator new during the run
+};
+
+/**
+ * @brief Offset of the chunk a request reads next, a cheap xorshift so both runs read the same chunks
+ *
+ * @param state Generator state
+ * @return off_t Chunk-aligned offset in the input file
+ */
+static off_t NextOffset(unsigned &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return static_cast<off_t>(state % FILE_CHUNKS) * static_cast<off_t>(CHUNK_SIZE);
+}
+
+/**
+ * @brief Offset of the output slot of a message, so the output file stays as big as the input
+ *
+ * @param request Number of the message
+ * @return off_t Offset in the output file
+ */
+static off_t OutputOffset(unsigned request)
+{
+    return static_cast<off_t>(request % OUTPUT_MESSAGES) * static_cast<off_t>(CHUNK_SIZE * CHUNKS_PER_REQUEST);
+}
+
+/**
+ * @brief Requests with one message vector, reused by every request: each chunk is read into its place
+ *  and the message is written with one pwrite (a single preadv can't gather from several offsets)
+ *
+ * @param in Input file
+ * @param out Output file
+ * @param requests Number of messages
+ * @return Result Cost
+ */
+static Result RunMessageVector(int in, int out, unsigned requests)
+{
+    Result result = {0, 0};
+    unsigned state = 2463534242u;
+    unsigned long long news = newCalls;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<char> message(CHUNK_SIZE * CHUNKS_PER_REQUEST);
+    for (unsigned r = 0; r < requests; ++r)
+    {
+        for (unsigned i = 0; i < CHUNKS_PER_REQUEST; ++i)
+            if (pread(in, message.data() + i * CHUNK_SIZE, CHUNK_SIZE, NextOffset(state)) != static_cast<ssize_t>(CHUNK_SIZE))
+                perror("pread");
+        if (pwrite(out, message.data(), message.size(), OutputOffset(r)) != static_cast<ssize_t>(message.size()))
+            perror("pwrite");
+    }
+    result.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.news_ = newCalls - news;
+    return result;
+}
+
+/**
+ * @brief Requests with a vector per chunk, written with one pwritev
+ *
+ * @param in Input file
+ * @param out Output file
+ * @param requests Number of messages
+ * @return Result Cost
+ */
+static Result RunChunkVectors(int in, int out, unsigned requests)
+{
+    Result result = {0, 0};
+    unsigned state = 2463534242u;
+    struct iovec iov[CHUNKS_PER_REQUEST];
+    unsigned long long news = newCalls;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < requests; ++r)
+    {
+        std::vector<std::vector<char>> chunks;
+        chunks.reserve(CHUNKS_PER_REQUEST);
+        for (unsigned i = 0; i < CHUNKS_PER_REQUEST; ++i)
+        {
+            chunks.emplace_back(CHUNK_SIZE);
+            iov[i].iov_base = chunks.back().data();
+            iov[i].iov_len = CHUNK_SIZE;
+            if (pread(in, iov[i].iov_base, CHUNK_SIZE, NextOffset(state)) != static_cast<ssize_t>(CHUNK_SIZE))
+                perror("pread");
+        }
+        if (pwritev(out, iov, CHUNKS_PER_REQUEST, OutputOffset(r)) != static_cast<ssize_t>(CHUNK_SIZE * CHUNKS_PER_REQUEST))
+            perror("pwritev");
+    }
+    result.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.news_ = newCalls - news;
+    return result;
+}
+
+/**
+ * @brief Requests with pool blocks read in place and written with one pwritev
+ *
+ * @param pool Pool of CHUNK_SIZE blocks aligned on CHUNK_SIZE
+ * @param in Input file
+ * @param out Output file
+ * @param requests Number of messages
+ * @return Result Cost
+ */
+static Result RunPool(ObjectAllocator &pool, int in, int out, unsigned requests)
+{
+    Result result = {0, 0};
+    unsigned state = 2463534242u;
+    struct iovec iov[CHUNKS_PER_REQUEST];
+    unsigned long long news = newCalls;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < requests; ++r)
+    {
+        pool.AllocateIov(CHUNKS_PER_REQUEST, iov);
+        for (unsigned i = 0; i < CHUNKS_PER_REQUEST; ++i)
+            if (pread(in, iov[i].iov_base, CHUNK_SIZE, NextOffset(state)) != static_cast<ssize_t>(CHUNK_SIZE))
+                perror("pread");
+        if (pwritev(out, iov, CHUNKS_PER_REQUEST, OutputOffset(r)) != static_cast<ssize_t>(CHUNK_SIZE * CHUNKS_PER_REQUEST))
+            perror("pwritev");
+        pool.FreeIov(CHUNKS_PER_REQUEST, iov);
+    }
+    result.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.news_ = newCalls - news;
+    return result;
+}
+
+/**
+ * @brief Opens a file, with O_DIRECT if the file system allows it
+ *
+ * @param path File
+ * @param flags open flags
+ * @param direct Tries O_DIRECT first, set to false if it was refused
+ * @return int Descriptor, -1 on failure
+ */
+static int Open(const char *path, int flags, bool &direct)
+{
+#ifdef O_DIRECT
+    if (direct)
+    {
+        int fd = open(path, flags | O_DIRECT, 0600);
+        if (fd >= 0)
+            return fd;
+    }
+#endif
+    direct = false;
+    return open(path, flags, 0600);
+}
+
+/**
+ * @brief Prints one result line
+ *
+ * @param name Buffers used
+ * @param result Cost
+ * @param requests Number of messages
+ */
+static void Print(const char *name, const Result &result, unsigned requests)
+{
+    printf("%-24s %10.3f %12.0f %14llu\n", name, result.seconds_, requests / result.seconds_, result.news_);
+}
+
+int main(int argc, char **argv)
+{
+    const char *directory = argc > 1 ? argv[1] : "/tmp";
+    unsigned requests = argc > 2 && atoi(argv[2]) > 0 ? static_cast<unsigned>(atoi(argv[2])) : DEFAULT_REQUESTS;
+    std::string input = std::string(directory) + "/oa-bench-io.in";
+    std::string output = std::string(directory) + "/oa-bench-io.out";
+
+    int fd = open(input.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+    {
+        perror(input.c_str());
+        return 1;
+    }
+    std::vector<char> fill(CHUNK_SIZE);
+    for (unsigned i = 0; i < FILE_CHUNKS; ++i)
+    {
+        memset(fill.data(), static_cast<int>(i), CHUNK_SIZE);
+        if (write(fd, fill.data(), CHUNK_SIZE) != static_cast<ssize_t>(CHUNK_SIZE))
+            perror("write");
+    }
+    close(fd);
+
+    //Buffered descriptors for the vectors, they aren't aligned for O_DIRECT
+    bool direct = false;
+    int in = Open(input.c_str(), O_RDONLY, direct);
+    int out = Open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, direct);
+    Result message = RunMessageVector(in, out, requests);
+    close(in);
+    close(out);
+    in = Open(input.c_str(), O_RDONLY, direct);
+    out = Open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, direct);
+    Result chunks = RunChunkVectors(in, out, requests);
+    close(in);
+    close(out);
+
+    //The pool blocks are aligned, so they may bypass the page cache
+    OAConfig config(false, CHUNKS_PER_REQUEST * 2, 0);
+    config.IOAlignment_ = CHUNK_SIZE;
+    ObjectAllocator pool(CHUNK_SIZE, config);
+    direct = true;
+    in = Open(input.c_str(), O_RDONLY, direct);
+    out = Open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, direct);
+    Result blocks = RunPool(pool, in, out, requests);
+    close(in);
+    close(out);
+    bool pooledDirect = direct;
+    direct = false;
+    in = Open(input.c_str(), O_RDONLY, direct);
+    out = Open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, direct);
+    Result buffered = RunPool(pool, in, out, requests);
+    close(in);
+    close(out);
+
+    printf("%u requests of %u x %u bytes in %s\n", requests, CHUNKS_PER_REQUEST, static_cast<unsigned>(CHUNK_SIZE), directory);
+    printf("%-24s %10s %12s %14s\n", "Buffers", "Seconds", "Requests/s", "operator new");
+    Print("reused message vector", message, requests);
+    Print("vectors + pwritev", chunks, requests);
+    Print("pool + pwritev", buffered, requests);
+    if (pooledDirect)
+        Print("pool + pwritev, O_DIRECT", blocks, requests);
+    else
+        printf("%-24s (the file system refused O_DIRECT)\n", "pool + pwritev, O_DIRECT");
+
+    unlink(input.c_str());
+    unlink(output.c_str());
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file bench-queue.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief Throughput benchmark of PoolQueue against a mutex around std::deque and a mutex around
+ * std::list (one new per message, like the queues it replaces). Producers and consumers pass a fixed
+ * number of messages through a bounded queue; prints messages per second and calls to operator new
+ * (starting the threads included).
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "PoolQueue.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const unsigned DEFAULT_THREADS = 2;        // producers, and as many consumers
+static const unsigned DEFAULT_MESSAGES = 1000000; // per producer
+static const size_t CAPACITY = 4096;              // bound of every queue
+
+static std::atomic<unsigned long long> newCalls; // calls to operator new, counted by the replacements below
+
+/**
+ * @brief Counting replacement of the global operator new
+ *
+ * @param size Bytes
+ * @return void* Memory
+ * @exception std::bad_alloc No memory
+ */
+void *operator new(size_t size)
+{
+    newCalls.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+/*!
+  A message, big enough to be more than a pointer
+*/
+struct Message
+{
+    unsigned long long sequence_; //!< number given by the producer
+    unsigned producer_;           //!< who sent it
+    unsigned payload_[5];         //!< stands for the rest of a real message
+};
+
+/*!
+  std::Container behind one mutex, bounded like PoolQueue
+*/
+template <typename Container>
+class LockedQueue
+{
+  public:
+    bool TryPush(const Message &message)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.size() >= CAPACITY)
+            return false;
+        queue_.push_back(message);
+        return true;
+    }
+
+    bool TryPop(Message &message)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty())
+            return false;
+        message = queue_.front();
+        queue_.pop_front();
+        return true;
+    }
+
+  private:
+    std::mutex mutex_;  // guards queue_
+    Container queue_;   // the messages
+};
+
+/**
+ * @brief Passes messages from producers to consumers through queue
+ *
+ * @param name Queue being measured
+ * @param queue Queue with TryPush/TryPop of Message
+ * @param threads Producers, and as many consumers
+ * @param messages Messages sent by each producer
+ */
+template <typename Queue>
+static void Run(const char *name, Queue &queue, unsigned threads, unsigned messages)
+{
+    std::atomic<unsigned long long> received{0}, checksum{0};
+    unsigned long long total = static_cast<unsigned long long>(threads) * messages;
+    unsigned long long news = newCalls.load();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned p = 0; p < threads; ++p)
+        workers.emplace_back([&queue, p, messages] {
+            Message message = {0, p, {0, 0, 0, 0, 0}};
+            for (unsigned i = 0; i < messages; ++i)
+            {
+                message.sequence_ = i;
+                while (!queue.TryPush(message))
+                    std::this_thread::yield();
+            }
+        });
+    for (unsigned c = 0; c < threads; ++c)
+        workers.emplace_back([&queue, &received, &checksum, total] {
+            Message message;
+            unsigned long long sum = 0;
+            while (received.load(std::memory_order_relaxed) < total)
+            {
+                if (queue.TryPop(message))
+                {
+                    sum += message.sequence_;
+                    received.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                    std::this_thread::yield();
+            }
+            checksum.fetch_add(sum);
+        });
+    for (std::thread &worker : workers)
+        worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    unsigned long long expected = static_cast<unsigned long long>(threads) * messages * (messages - 1ULL) / 2;
+    printf("%-26s %10.3f %14.0f %14llu %s\n", name, seconds, total / seconds, newCalls.load() - news,
+           checksum.load() == expected ? "" : "(LOST MESSAGES)");
+}
+
+int main(int argc, char **argv)
+{
+    unsigned threads = argc > 1 && atoi(argv[1]) > 0 ? static_cast<unsigned>(atoi(argv[1])) : DEFAULT_THREADS;
+    unsigned messages = argc > 2 && atoi(argv[2]) > 0 ? static_cast<unsigned>(atoi(argv[2])) : DEFAULT_MESSAGES;
+
+    printf("%u producers, %u consumers, %u messages each, capacity %u, %u hardware threads\n", threads, threads, messages,
+           static_cast<unsigned>(CAPACITY), std::thread::hardware_concurrency());
+    printf("%-26s %10s %14s %14s\n", "Queue", "Seconds", "Messages/s", "operator new");
+    {
+        LockedQueue<std::list<Message>> queue;
+        Run("mutex + std::list", queue, threads, messages);
+    }
+    {
+        LockedQueue<std::deque<Message>> queue;
+        Run("mutex + std::deque", queue, threads, messages);
+    }
+    {
+        PoolQueue<Message> queue(CAPACITY);
+        Run("PoolQueue", queue, threads, messages);
+        printf("PoolQueue nodes: %u pages of %u\n", queue.GetStats().PagesInUse_, PoolQueue<Message>::DEFAULT_BATCH);
+    }
+    return 0;
+}
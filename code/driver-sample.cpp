@@ -2,6 +2,8 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <sys/uio.h>
+#include <thread>
 
 using std::cout;
 using std::endl;
@@ -14,6 +16,15 @@ int SHOW_EXCEPTIONS = 0;
 
 #include "ObjectAllocator.h"
 #include "PRNG.h"
+#include "PageCache.h"
+#include "BoundedObjectAllocator.h"
+#include "StripedObjectAllocator.h"
+#include "FlatCombiningAllocator.h"
+#include "PoolQueue.h"
+#include "PageProvisioner.h"
+#include "PageReclaimer.h"
+#include "ForkFriendlyAllocator.h"
+#include "PoolRegistry.h"
 
 struct Student
 {
@@ -57,6 +68,25 @@ void TestFreeEmptyPages2(void);       // debug, padding=2, header, align=16
 void TestFreeEmptyPages3(void);       // debug, padding=6
 void StressFreeChecking(void);        //
 void Stress(bool UseNewDelete);       // 
+void TestChecksums(void);             // checksums, header
+void TestDebugStateLive(void);        // padding=2, header, debug switched on/off while in use
+void TestPageCache(void);             // debug, padding=2, PageBytes=4096, two size classes
+void TestAllocateIov(void);           // debug, IOAlignment=64, MaxPages=2
+void TestLabels(void);                // debug, header, TrackLabels
+void TestLifetimes(void);             // TrackLabels, Lifetimes=ltAllocations
+void TestSnapshots(void);             // header, TrackLabels
+void TestStaleObjects(void);          // header, TrackLabels
+void TestBounded(void);               // MaxPages=1, a second thread waits for a block
+void TestStriped(void);               // 4 threads
+void TestFlatCombining(void);         // debug, 4 threads
+void TestPoolQueue(void);             // 2 producers, 2 consumers
+void TestSparePages(void);            // debug, padding=2, ProvisionWatermark=2
+void TestReclaimer(void);             // FreeEmptyPages hands the pages to a worker thread
+void TestForkFriendly(void);          // header
+void TestPoolRegistry(void);          // default PoolTraits
+void TestOOMHandler(void);            // MaxPages=1, the handler raises it once
+void TestPageBytes(void);             // debug, padding=2, header, PageBytes=8192
+void TestAdaptivePages(void);         // debug, AdaptivePages, 4 to 64 objects per page
 
 struct Person
 {
@@ -168,6 +198,16 @@ void ValidateCallback(const void* block, size_t actual_size)
         return;
 }
 
+void PrintException(const char* where, const OAException& e)
+{
+    static const char* const CODES[] = { "E_NO_MEMORY", "E_NO_PAGES", "E_BAD_BOUNDARY", "E_MULTIPLE_FREE", "E_CORRUPTED_BLOCK" };
+
+    if (SHOW_EXCEPTIONS)
+        cout << e.what() << endl;
+    else
+        cout << "Exception thrown from " << where << ": " << CODES[e.code()] << endl;
+}
+
 //****************************************************************************************************
 //****************************************************************************************************
 int RandomInt(int low, int high)
@@ -1716,108 +1756,1114 @@ void TestAlignment(void)
 }
 
 
-void PrintCounts(const ObjectAllocator* nm)
+//****************************************************************************************************
+//****************************************************************************************************
+void TestChecksums(void)
 {
-    OAStats stats = nm->GetStats();
-    cout << "Pages in use: " << stats.PagesInUse_;
-    cout << ", Objects in use: " << stats.ObjectsInUse_;
-    cout << ", Available objects: " << stats.FreeObjects_;
-    cout << ", Allocs: " << stats.Allocations_;
-    cout << ", Frees: " << stats.Deallocations_ << endl;
+    ObjectAllocator* oa = 0;
+    Student* pStudent1 = 0, * pStudent2 = 0;
+    unsigned count;
+    try
+    {
+        bool newdel = false;
+        bool debug = false; // the checksums catch these without the debug checks
+        unsigned padbytes = 0;
+        OAConfig::HeaderBlockInfo header(OAConfig::hbBasic);
+        unsigned alignment = 0;
+
+        OAConfig config(newdel, 4, 2, debug, padbytes, header, alignment);
+        config.Checksums_ = true;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        pStudent1 = static_cast<Student*>(oa->Allocate());
+        pStudent2 = static_cast<Student*>(oa->Allocate());
+        oa->Allocate(); // 3
+        oa->Free(pStudent1);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown during construction/allocation in TestChecksums." << endl;
+        delete oa;
+        return;
+    }
+
+    try
+    {
+        oa->Free(pStudent1); // free it again
+        cout << "****** Double free not detected in TestChecksums. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Free (double free)", e);
+    }
+    count = oa->ValidatePages(ValidateCallback);
+    cout << "Number of corruptions: " << count << endl << endl;
+
+    // overwrite the allocation number in the header of 2
+    *(reinterpret_cast<unsigned char*>(pStudent2) - OAConfig::BASIC_HEADER_SIZE) ^= 0xFF;
+    count = oa->ValidatePages(ValidateCallback);
+    cout << "Number of corruptions: " << count << endl << endl;
+    try
+    {
+        oa->Free(pStudent2);
+        cout << "****** Corrupted header not detected in TestChecksums. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Free (header)", e);
+    }
+
+    // write to 1 after it was freed, overwriting its free list link
+    pStudent1->Age = 0x12345678;
+    count = oa->ValidatePages(ValidateCallback);
+    cout << "Number of corruptions: " << count << endl << endl;
+    try
+    {
+        oa->Allocate();
+        cout << "****** Corrupted free block not detected in TestChecksums. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Allocate (free block)", e);
+    }
+
+    delete oa;
 }
 
-void PrintCounts2(const ObjectAllocator* nm)
+//****************************************************************************************************
+//****************************************************************************************************
+void TestDebugStateLive(void)
 {
-    OAStats stats = nm->GetStats();
-    cout << "Allocs: " << stats.Allocations_;
-    cout << ", Frees: " << stats.Deallocations_ << endl;
+    ObjectAllocator* oa = 0;
+    Student* pStudent1 = 0, * pStudent4 = 0;
+    unsigned char* p;
+    unsigned i, count, padbytes = 2;
+    try
+    {
+        bool newdel = false;
+        bool debug = false; // switched on once the first page is in use
+        OAConfig::HeaderBlockInfo header(OAConfig::hbBasic);
+        unsigned alignment = 0;
+
+        OAConfig config(newdel, 4, 2, debug, padbytes, header, alignment);
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        pStudent1 = static_cast<Student*>(oa->Allocate());
+        oa->Allocate(); // 2
+        oa->Allocate(); // 3
+        oa->SetDebugState(true);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown during construction/allocation in TestDebugStateLive." << endl;
+        delete oa;
+        return;
+    }
+
+    // the pads of the blocks allocated while debugging was off aren't painted, nothing to report yet
+    count = oa->ValidatePages(ValidateCallback);
+    cout << "Number of corruptions: " << count << endl << endl;
+
+    try
+    {
+        oa->Free(pStudent1);
+        cout << "Freed a block allocated while debugging was off" << endl;
+        oa->Free(pStudent1); // free it again
+        cout << "****** Double free not detected in TestDebugStateLive. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Free (double free)", e);
+    }
+
+    try
+    {
+        // 1 again, now with painted pads: corrupt its right pad bytes
+        pStudent1 = static_cast<Student*>(oa->Allocate());
+        p = reinterpret_cast<unsigned char*>(pStudent1) + sizeof(Student);
+        for (i = 0; i < padbytes; i++)
+            *p++ = 0xEE;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Allocate", e);
+    }
+    count = oa->ValidatePages(ValidateCallback);
+    cout << "Number of corruptions: " << count << endl << endl;
+    try
+    {
+        oa->Free(pStudent1);
+        cout << "****** Corrupted pad bytes not detected in TestDebugStateLive. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Free (right pad)", e);
+    }
+
+    try
+    {
+        // a block allocated while debugging is off again mustn't look freed once it is back on
+        oa->SetDebugState(false);
+        pStudent4 = static_cast<Student*>(oa->Allocate());
+        oa->SetDebugState(true);
+        oa->Free(pStudent4);
+        cout << "Freed a block allocated after debugging was switched off and on" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Free (debugging switched off and on)", e);
+    }
+
+    delete oa;
 }
 
-void PrintConfig(const ObjectAllocator* oa)
+//****************************************************************************************************
+//****************************************************************************************************
+void PrintCache(const PageCache& cache)
 {
-    cout << "Object size = " << oa->GetStats().ObjectSize_;
-    cout << ", Page size = " << oa->GetStats().PageSize_;
-    cout << ", Pad bytes = " << oa->GetConfig().PadBytes_;
-    cout << ", ObjectsPerPage = " << oa->GetConfig().ObjectsPerPage_;
-    cout << ", MaxPages = " << oa->GetConfig().MaxPages_;
-    cout << ", MaxObjects = " << oa->GetConfig().ObjectsPerPage_ * oa->GetConfig().MaxPages_;
-    cout << endl;
-    cout << "Alignment = " << oa->GetConfig().Alignment_;
-    cout << ", LeftAlign = " << oa->GetConfig().LeftAlignSize_;
-    cout << ", InterAlign = " << oa->GetConfig().InterAlignSize_;
-    cout << ", HeaderBlocks = ";
-    if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbNone)
-        cout << "None";
-    else if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbBasic)
-        cout << "Basic";
-    else if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbExtended)
-        cout << "Extended";
-    else if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbExternal)
-        cout << "External";
-    cout << ", Header size = " << oa->GetConfig().HBlockInfo_.size_;
-    cout << endl;
+    cout << "Cached pages: " << cache.Cached() << ", hits: " << cache.Hits() << ", misses: " << cache.Misses() << endl;
 }
 
-void DumpPages(const ObjectAllocator* nm, unsigned width)
+void TestPageCache(void)
 {
-    const unsigned char* pages = static_cast<const unsigned char*>(nm->GetPageList());
-    const unsigned char* realpage = pages;
+    PageCache cache(4096);
+    PageCache other(8192);
+    ObjectAllocator* students = 0, * employees = 0;
+    Student* pStudents[3];
+    Employee* pEmployees[2];
+    const void* studentPage;
+    unsigned i, count;
+    try
+    {
+        bool newdel = false;
+        bool debug = true;
+        unsigned padbytes = 2;
+        unsigned alignment = 0;
 
-    size_t header_size = nm->GetConfig().HBlockInfo_.size_;
+        OAConfig config(newdel, 0, 0, debug, padbytes, OAConfig::HeaderBlockInfo(OAConfig::hbBasic), alignment);
+        config.PageBytes_ = cache.PageBytes();
+        students = new ObjectAllocator(sizeof(Student), config);
+        config.HBlockInfo_ = OAConfig::HeaderBlockInfo(OAConfig::hbExtended, 4);
+        employees = new ObjectAllocator(sizeof(Employee), config);
+
+        cout << "Students use a cache of 8192 byte pages: " << students->SetPageCache(&other) << endl;
+        cout << "Students use a cache of 4096 byte pages: " << students->SetPageCache(&cache) << endl;
+        cout << "Employees use a cache of 4096 byte pages: " << employees->SetPageCache(&cache) << endl;
+
+        // the first page of each was made by its constructor, before it had a cache
+        cout << "Employee pages freed: " << employees->FreeEmptyPages() << endl;
+        PrintCache(cache);
+        for (i = 0; i < 3; i++)
+            pStudents[i] = static_cast<Student*>(students->Allocate());
+        for (i = 0; i < 3; i++)
+            students->Free(pStudents[i]);
+        studentPage = students->GetPageList();
+        cout << "Student pages freed: " << students->FreeEmptyPages() << endl;
+        PrintCache(cache);
+
+        // the page the students gave back last is reformatted for employees
+        for (i = 0; i < 2; i++)
+            pEmployees[i] = static_cast<Employee*>(employees->Allocate());
+        cout << "Employees reuse the student page: " << (employees->GetPageList() == studentPage) << endl;
+        PrintCache(cache);
+        count = employees->ValidatePages(ValidateCallback);
+        cout << "Number of corruptions: " << count << endl;
+        for (i = 0; i < 2; i++)
+            employees->Free(pEmployees[i]);
+        cout << "Employee pages freed: " << employees->FreeEmptyPages() << endl;
+        PrintCache(cache);
+
+        // and back to students
+        pStudents[0] = static_cast<Student*>(students->Allocate());
+        cout << "Students reuse the student page: " << (students->GetPageList() == studentPage) << endl;
+        count = students->ValidatePages(ValidateCallback);
+        cout << "Number of corruptions: " << count << endl;
+        students->Free(pStudents[0]);
+        PrintCache(cache);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestPageCache." << endl;
+    }
 
-    while (pages)
+    // the allocators go first, they may hand pages back to the cache
+    delete employees;
+    delete students;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestAllocateIov(void)
+{
+    ObjectAllocator* oa = 0;
+    struct iovec iov[4];
+    unsigned i;
+    try
     {
-        unsigned count = 0;
+        bool newdel = false;
+        bool debug = true;
+        unsigned padbytes = 0;
+        OAConfig::HeaderBlockInfo header(OAConfig::hbNone);
+        unsigned alignment = 0;
 
-        if (SHOWREAL)
-            printf("%p\n", pages);
+        OAConfig config(newdel, 4, 2, debug, padbytes, header, alignment);
+        config.IOAlignment_ = 64;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        for (i = 0; i < 5; i++)
+            oa->Allocate();
+        PrintCounts(oa);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
         else
-            printf("XXXXXXXX\n");
+            cout << "Exception thrown during construction/allocation in TestAllocateIov." << endl;
+        delete oa;
+        return;
+    }
 
-        // print column header
-        for (unsigned j = 0; j < width; j++)
-            printf(" %2i", j);
-        printf("\n");
+    try
+    {
+        // 3 blocks are left and no page can be added: none of the 4 may stay allocated
+        oa->AllocateIov(4, iov);
+        cout << "****** E_NO_PAGES not thrown in TestAllocateIov. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("AllocateIov", e);
+    }
+    PrintCounts(oa);
 
-        // "Next page" pointer in the page
-        if (SHOWREAL)
-        {
-            for (unsigned i = 0; i < sizeof(void*); i++, count++)
-                printf(" %02X", *pages++);
-        }
-        else
-        {
-            for (unsigned j = 0; j < sizeof(void*); pages++, count++, j++)
-                printf(" %s", "XX");
-        }
+    try
+    {
+        oa->AllocateIov(3, iov);
+        for (i = 0; i < 3; i++)
+            if (reinterpret_cast<size_t>(iov[i].iov_base) % 64 || iov[i].iov_len != sizeof(Student))
+                cout << "****** Block " << i << " has a bad address or length in TestAllocateIov. ******" << endl;
+        PrintCounts(oa);
+        oa->FreeIov(3, iov);
+        PrintCounts(oa);
+    }
+    catch (const OAException& e)
+    {
+        PrintException("AllocateIov/FreeIov", e);
+    }
 
+    delete oa;
+}
 
-        // Left leading alignment bytes
-        if (nm->GetConfig().Alignment_ > 1)
-        {
-            // leading alignment block (if any)
-            for (unsigned j = 0; j < nm->GetConfig().LeftAlignSize_; count++, j++)
-            {
-                if (count >= width)
-                {
-                    printf("\n");
-                    count = 0;
-                }
-                printf(" %02X", *pages++);
-            }
-        }
+//****************************************************************************************************
+//****************************************************************************************************
+void LabelCallback(const char* label, const OALabelStats& stats)
+{
+    printf("%-8s in use: %u, bytes: %u, most: %u, allocs: %u, frees: %u\n", label ? label : "(none)", stats.ObjectsInUse_,
+           static_cast<unsigned>(stats.BytesInUse_), stats.MostObjects_, stats.Allocations_, stats.Deallocations_);
+}
 
-        // Dump each object and its associated info
-        for (unsigned int i = 0; i < nm->GetConfig().ObjectsPerPage_; i++)
-        {
-            // inter-block alignment (not on first block)
-            if (i > 0)
-            {
-                for (unsigned j = 0; j < nm->GetConfig().InterAlignSize_; count++, j++)
-                {
-                    if (count >= width)
-                    {
-                        printf("\n");
+void TestLabels(void)
+{
+    ObjectAllocator* oa = 0;
+    Student* pMesh[3];
+    char name[] = "sound";
+    unsigned i;
+    try
+    {
+        bool newdel = false;
+        bool debug = true;
+        unsigned padbytes = 0;
+        OAConfig::HeaderBlockInfo header(OAConfig::hbBasic);
+        unsigned alignment = 0;
+
+        OAConfig config(newdel, 4, 0, debug, padbytes, header, alignment);
+        config.TrackLabels_ = true;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        for (i = 0; i < 3; i++)
+            pMesh[i] = static_cast<Student*>(oa->Allocate("mesh"));
+        oa->Allocate(name);
+        name[0] = 'S'; // the label is copied, not kept
+        oa->Allocate("sound");
+        oa->Allocate(); // unlabelled
+        oa->Free(pMesh[0]);
+        oa->Free(pMesh[1]);
+
+        unsigned count = oa->DumpLabelStats(LabelCallback);
+        cout << "Number of labels: " << count << endl << endl;
+        LabelCallback("mesh", oa->GetLabelStats("mesh"));
+        LabelCallback("Sound", oa->GetLabelStats("Sound"));
+        PrintCounts(oa);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestLabels." << endl;
+    }
+    delete oa;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void PrintHistogram(const char* label, const OALifetimeHistogram& histogram)
+{
+    printf("%-8s lifetimes: %llu, total: %llu, longest: %llu, median at most: %llu\n", label, histogram.Samples_,
+           histogram.Total_, histogram.Longest_, histogram.Samples_ ? histogram.Percentile(0.5) : 0ULL);
+}
+
+void TestLifetimes(void)
+{
+    ObjectAllocator* oa = 0;
+    void* blocks[8];
+    OALongLived longest[3];
+    unsigned i;
+    try
+    {
+        OAConfig config(false, 4, 0);
+        config.TrackLabels_ = true;
+        config.Lifetimes_ = OAConfig::ltAllocations;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        // a long-lived mesh and short-lived particles
+        blocks[0] = oa->Allocate("mesh");
+        for (i = 1; i < 8; i++)
+        {
+            blocks[i] = oa->Allocate("particle");
+            if (i > 1)
+                oa->Free(blocks[i - 1]); // each lives for 1 allocation
+        }
+        oa->Free(blocks[7]); // lived for 0
+        oa->Free(blocks[0]); // lived for 7
+
+        PrintHistogram("all", oa->GetLifetimeHistogram());
+        PrintHistogram("mesh", oa->GetLifetimeHistogram("mesh"));
+        PrintHistogram("particle", oa->GetLifetimeHistogram("particle"));
+
+        unsigned count = oa->GetLongestLived(longest, 3);
+        for (i = 0; i < count; i++)
+            printf("Lived %llu allocations, born at %llu: %s\n", longest[i].Lifetime_, longest[i].Birth_,
+                   longest[i].Label_ ? longest[i].Label_ : "(none)");
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestLifetimes." << endl;
+    }
+    delete oa;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void SnapshotCallback(const char* label, const OASnapshotDelta& delta)
+{
+    printf("%-8s allocated: %u, freed: %u, net bytes: %lld, first allocation: %u\n", label ? label : "(none)",
+           delta.Allocated_, delta.Freed_, delta.NetBytes_, delta.FirstAllocNum_);
+}
+
+void TestSnapshots(void)
+{
+    ObjectAllocator* oa = 0;
+    void* pMesh[4];
+    unsigned i, count;
+    try
+    {
+        OAConfig config(false, 4, 0, false, 0, OAConfig::HeaderBlockInfo(OAConfig::hbBasic));
+        config.TrackLabels_ = true;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        for (i = 0; i < 4; i++)
+            pMesh[i] = oa->Allocate("mesh");
+        oa->Allocate("sound");
+        OASnapshot before = oa->TakeLiveSnapshot();
+
+        // a level change: meshes replaced, sounds leaked
+        for (i = 0; i < 3; i++)
+            oa->Free(pMesh[i]);
+        oa->Allocate("mesh");
+        for (i = 0; i < 5; i++)
+            oa->Allocate("sound");
+        OASnapshot after = oa->TakeLiveSnapshot();
+
+        cout << "Live blocks: " << before.Live_.size() << " then " << after.Live_.size() << endl;
+        count = oa->DiffSnapshots(before, after, SnapshotCallback);
+        cout << "Labels changed: " << count << endl;
+        count = oa->DiffSnapshots(after, after, SnapshotCallback);
+        cout << "Labels changed: " << count << endl;
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestSnapshots." << endl;
+    }
+    delete oa;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void StaleCallback(const char* label, const OAStaleStats& stats)
+{
+    printf("%-8s stale: %u, bytes: %u, oldest age: %llu\n", label ? label : "(none)", stats.Objects_,
+           static_cast<unsigned>(stats.Bytes_), stats.OldestAge_);
+}
+
+void TestStaleObjects(void)
+{
+    ObjectAllocator* oa = 0;
+    void* block;
+    unsigned i, count;
+    try
+    {
+        OAConfig config(false, 4, 0, false, 0, OAConfig::HeaderBlockInfo(OAConfig::hbBasic));
+        config.TrackLabels_ = true;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        oa->Allocate("cache");
+        oa->Allocate("cache");
+        oa->Allocate(); // unlabelled
+        for (i = 0; i < 10; i++) // short-lived traffic ages them
+        {
+            block = oa->Allocate("frame");
+            oa->Free(block);
+        }
+        oa->Allocate("frame");
+
+        count = oa->DumpStaleObjects(10, OAConfig::ltAllocations, StaleCallback);
+        cout << "Labels with stale blocks: " << count << endl;
+        count = oa->DumpStaleObjects(100, OAConfig::ltAllocations, StaleCallback);
+        cout << "Labels with stale blocks: " << count << endl;
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestStaleObjects." << endl;
+    }
+    delete oa;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestBounded(void)
+{
+    try
+    {
+        OAConfig config(false, 4, 1); // the bound is 1 page of 4 blocks
+        BoundedObjectAllocator pool(sizeof(Student), config);
+        void* blocks[4];
+        void* waited = 0;
+        unsigned i;
+
+        for (i = 0; i < 4; i++)
+            blocks[i] = pool.Allocate();
+        cout << "TryAllocate when exhausted: " << (pool.TryAllocate() ? "block" : "null") << endl;
+        cout << "AllocateFor(10ms) when exhausted: " << (pool.AllocateFor(std::chrono::milliseconds(10)) ? "block" : "null") << endl;
+
+        std::thread waiter([&pool, &waited] { waited = pool.Allocate(); });
+        while (!pool.Waiting())
+            std::this_thread::yield();
+        cout << "Waiting: " << pool.Waiting() << endl;
+        pool.Free(blocks[2]);
+        waiter.join();
+        cout << "The waiter got the freed block: " << (waited == blocks[2]) << endl;
+
+        blocks[2] = waited;
+        for (i = 0; i < 4; i++)
+            pool.Free(blocks[i]);
+        OAStats stats = pool.GetStats();
+        cout << "Pages in use: " << stats.PagesInUse_ << ", Objects in use: " << stats.ObjectsInUse_
+             << ", Allocs: " << stats.Allocations_ << ", Frees: " << stats.Deallocations_ << endl;
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestBounded." << endl;
+    }
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+// Each of threads threads allocates 8 blocks at a time, stamps them, checks them and frees them
+template <typename Pool>
+void Churn(Pool& pool, unsigned threads, unsigned rounds)
+{
+    const unsigned BATCH = 8;
+    std::thread* workers = new std::thread[threads];
+    unsigned* clashes = new unsigned[threads]();
+    for (unsigned t = 0; t < threads; t++)
+        workers[t] = std::thread([&pool, &clashes, t, rounds] {
+            Student* batch[BATCH];
+            for (unsigned r = 0; r < rounds; r++)
+            {
+                for (unsigned i = 0; i < BATCH; i++)
+                {
+                    batch[i] = static_cast<Student*>(pool.Allocate());
+                    batch[i]->ID = static_cast<long>(t * BATCH + i);
+                }
+                for (unsigned i = 0; i < BATCH; i++)
+                {
+                    if (batch[i]->ID != static_cast<long>(t * BATCH + i)) // handed to two threads at once
+                        clashes[t]++;
+                    pool.Free(batch[i]);
+                }
+            }
+        });
+    unsigned total = 0;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers[t].join();
+        total += clashes[t];
+    }
+    delete[] workers;
+    delete[] clashes;
+
+    OAStats stats = pool.GetStats();
+    cout << "Blocks given to two threads: " << total << endl;
+    cout << "Objects in use: " << stats.ObjectsInUse_ << ", Allocs: " << stats.Allocations_
+         << ", Frees: " << stats.Deallocations_ << endl;
+}
+
+void TestStriped(void)
+{
+    try
+    {
+        OAConfig config(false, 16, 0);
+        StripedObjectAllocator pool(sizeof(Student), config, 4);
+        Churn(pool, 4, 1000);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestStriped." << endl;
+    }
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestFlatCombining(void)
+{
+    try
+    {
+        OAConfig config(false, 16, 0, true, 2);
+        FlatCombiningAllocator pool(sizeof(Student), config, 4);
+        Churn(pool, 4, 1000);
+        cout << "Requests served by combining: " << (pool.Requests() == 64000) << endl;
+
+        // an error raised while combining reaches the thread that made the request
+        Student outside;
+        void* block = pool.Allocate();
+        try
+        {
+            pool.Free(&outside);
+            cout << "****** Bad boundary not detected in TestFlatCombining. ******" << endl;
+        }
+        catch (const OAException& e)
+        {
+            PrintException("Free", e);
+        }
+        pool.Free(block); // the combiner lock isn't left held
+        cout << "Freed after the exception" << endl;
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestFlatCombining." << endl;
+    }
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestPoolQueue(void)
+{
+    try
+    {
+        PoolQueue<unsigned> queue(16, 4);
+        unsigned i, value, pushed = 0, inOrder = 1;
+
+        while (queue.TryPush(pushed))
+            pushed++;
+        cout << "Pushed until full: " << pushed << ", size: " << queue.Size() << endl;
+        for (i = 0; queue.TryPop(value); i++)
+            inOrder = inOrder && value == i;
+        cout << "Popped: " << i << ", in order: " << inOrder << ", size: " << queue.Size() << endl;
+
+        const unsigned COUNT = 10000;
+        unsigned long long sums[2] = { 0, 0 };
+        unsigned popped[2] = { 0, 0 };
+        std::thread producers[2], consumers[2];
+        for (unsigned t = 0; t < 2; t++)
+        {
+            producers[t] = std::thread([&queue, t, COUNT] {
+                for (unsigned v = 1; v <= COUNT; v++)
+                    while (!queue.TryPush(t * COUNT + v))
+                        std::this_thread::yield();
+            });
+            consumers[t] = std::thread([&queue, &sums, &popped, t, COUNT] {
+                unsigned v;
+                while (popped[t] < COUNT)
+                    if (queue.TryPop(v))
+                    {
+                        sums[t] += v;
+                        popped[t]++;
+                    }
+                    else
+                        std::this_thread::yield();
+            });
+        }
+        for (unsigned t = 0; t < 2; t++)
+        {
+            producers[t].join();
+            consumers[t].join();
+        }
+        cout << "Popped: " << popped[0] + popped[1] << ", sum: " << sums[0] + sums[1] << ", size: " << queue.Size() << endl;
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestPoolQueue." << endl;
+    }
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestSparePages(void)
+{
+    PageProvisioner provisioner; // outlives the allocator
+    ObjectAllocator* oa = 0;
+    void* blocks[20];
+    unsigned i, count;
+    try
+    {
+        OAConfig config(false, 4, 0, true, 2, OAConfig::HeaderBlockInfo(OAConfig::hbBasic));
+        config.ProvisionWatermark_ = 2;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        cout << "Spare page prepared with 4 free: " << oa->PrepareSparePage() << endl;
+        for (i = 0; i < 3; i++)
+            blocks[i] = oa->Allocate();
+        cout << "Spare page prepared with 1 free: " << oa->PrepareSparePage() << endl;
+        cout << "Spare page prepared again: " << oa->PrepareSparePage() << endl;
+        PrintCounts(oa);
+        for (; i < 5; i++) // the 5th block comes from the spare page
+            blocks[i] = oa->Allocate();
+        PrintCounts(oa);
+        count = oa->ValidatePages(ValidateCallback);
+        cout << "Number of corruptions: " << count << endl;
+
+        // the same on a worker thread, when it gets to it
+        oa->SetProvisioner(&provisioner);
+        for (; i < 20; i++)
+            blocks[i] = oa->Allocate();
+        PrintCounts(oa);
+        count = oa->ValidatePages(ValidateCallback);
+        cout << "Number of corruptions: " << count << endl;
+        for (i = 0; i < 20; i++)
+            oa->Free(blocks[i]);
+        PrintCounts(oa);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestSparePages." << endl;
+    }
+    delete oa;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestReclaimer(void)
+{
+    PageReclaimer reclaimer(2); // outlives the allocator
+    ObjectAllocator* oa = 0;
+    void* blocks[12];
+    unsigned i;
+    try
+    {
+        OAConfig config(false, 4, 0);
+        oa = new ObjectAllocator(sizeof(Student), config);
+        oa->SetReclaimer(&reclaimer);
+
+        for (i = 0; i < 12; i++)
+            blocks[i] = oa->Allocate();
+        for (i = 4; i < 12; i++) // empties the last 2 pages
+            oa->Free(blocks[i]);
+        cout << "Pages freed: " << oa->FreeEmptyPages() << endl;
+        reclaimer.Flush();
+        cout << "Pages reclaimed: " << reclaimer.PagesReclaimed() << ", pending: " << reclaimer.Pending() << endl;
+        PrintCounts(oa);
+
+        for (i = 4; i < 12; i++) // new pages, the released ones are gone
+            blocks[i] = oa->Allocate();
+        for (i = 0; i < 12; i++)
+            oa->Free(blocks[i]);
+        cout << "Pages freed: " << oa->FreeEmptyPages() << endl;
+        reclaimer.Flush();
+        cout << "Pages reclaimed: " << reclaimer.PagesReclaimed() << ", pending: " << reclaimer.Pending() << endl;
+        PrintCounts(oa);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestReclaimer." << endl;
+    }
+    delete oa;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestForkFriendly(void)
+{
+    try
+    {
+        OAConfig config(false, 4, 0, false, 0, OAConfig::HeaderBlockInfo(OAConfig::hbBasic));
+        ForkFriendlyAllocator pool(sizeof(Student), config);
+        unsigned char* blocks[6];
+        unsigned i;
+
+        for (i = 0; i < 6; i++)
+            blocks[i] = static_cast<unsigned char*>(pool.Allocate());
+        pool.Free(blocks[2]);
+        cout << "Allocation numbers: " << pool.AllocationNumber(blocks[0]) << " " << pool.AllocationNumber(blocks[2])
+             << " " << pool.AllocationNumber(blocks[5]) << endl;
+        cout << "Blocks in use: " << pool.DumpMemoryInUse(DumpCallback2) << endl;
+        cout << "Metadata outside the pages: " << (pool.MetadataBytes() > 0) << endl;
+
+        try
+        {
+            pool.Free(blocks[2]);
+            cout << "****** Double free not detected in TestForkFriendly. ******" << endl;
+        }
+        catch (const OAException& e)
+        {
+            PrintException("Free (double free)", e);
+        }
+        try
+        {
+            pool.Free(blocks[3] + 1);
+            cout << "****** Bad boundary not detected in TestForkFriendly. ******" << endl;
+        }
+        catch (const OAException& e)
+        {
+            PrintException("Free (inside a block)", e);
+        }
+
+        blocks[2] = static_cast<unsigned char*>(pool.Allocate()); // reuses the freed block
+        cout << "Allocation number of the reused block: " << pool.AllocationNumber(blocks[2]) << endl;
+        for (i = 0; i < 6; i++)
+            pool.Free(blocks[i]);
+        OAStats stats = pool.GetStats();
+        cout << "Objects in use: " << stats.ObjectsInUse_ << ", Allocs: " << stats.Allocations_
+             << ", Frees: " << stats.Deallocations_ << endl;
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestForkFriendly." << endl;
+    }
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+struct alignas(64) CacheLine
+{
+    char bytes[64];
+};
+
+struct Fussy
+{
+    explicit Fussy(int value) : value_(value)
+    {
+        if (value < 0)
+            throw value;
+    }
+    int value_;
+};
+
+void TestPoolRegistry(void)
+{
+    try
+    {
+        Student* student = PoolRegistry::New<Student>();
+        CacheLine* lines[3];
+        unsigned i, aligned = 1;
+        for (i = 0; i < 3; i++)
+        {
+            lines[i] = PoolRegistry::New<CacheLine>();
+            aligned = aligned && reinterpret_cast<size_t>(lines[i]) % alignof(CacheLine) == 0;
+        }
+        cout << "Over-aligned objects aligned: " << aligned << endl;
+        cout << "Students in use: " << PoolRegistry::Pool<Student>().GetStats().ObjectsInUse_
+             << ", cache lines in use: " << PoolRegistry::Pool<CacheLine>().GetStats().ObjectsInUse_ << endl;
+
+        Fussy* fussy = PoolRegistry::New<Fussy>(1);
+        try
+        {
+            PoolRegistry::New<Fussy>(-1);
+            cout << "****** Constructor didn't throw in TestPoolRegistry. ******" << endl;
+        }
+        catch (int)
+        {
+            cout << "Constructor threw, Fussy objects in use: " << PoolRegistry::Pool<Fussy>().GetStats().ObjectsInUse_ << endl;
+        }
+
+        PoolRegistry::Delete(fussy);
+        for (i = 0; i < 3; i++)
+            PoolRegistry::Delete(lines[i]);
+        PoolRegistry::Delete(student);
+        cout << "Students in use: " << PoolRegistry::Pool<Student>().GetStats().ObjectsInUse_
+             << ", cache lines in use: " << PoolRegistry::Pool<CacheLine>().GetStats().ObjectsInUse_ << endl;
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestPoolRegistry." << endl;
+    }
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+unsigned OOMCalls = 0;
+
+bool RaiseMaxPagesOnce(ObjectAllocator& oa, OAException::OA_EXCEPTION code)
+{
+    cout << "OOM handler called for " << (code == OAException::E_NO_PAGES ? "E_NO_PAGES" : "E_NO_MEMORY") << endl;
+    if (OOMCalls++)
+        return false; // give up, the exception is thrown
+    oa.SetMaxPages(2);
+    return true;
+}
+
+void TestOOMHandler(void)
+{
+    ObjectAllocator* oa = 0;
+    unsigned i;
+    try
+    {
+        OAConfig config(false, 4, 1);
+        oa = new ObjectAllocator(sizeof(Student), config);
+        cout << "Previous handler: " << (oa->SetOOMHandler(RaiseMaxPagesOnce) ? "set" : "none") << endl;
+
+        for (i = 0; i < 9; i++)
+            oa->Allocate();
+        cout << "****** E_NO_PAGES not thrown in TestOOMHandler. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("Allocate", e);
+    }
+    if (oa)
+    {
+        PrintCounts(oa);
+        delete oa;
+    }
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestPageBytes(void)
+{
+    ObjectAllocator* oa = 0;
+    try
+    {
+        OAConfig config(false, 0, 0, true, 2, OAConfig::HeaderBlockInfo(OAConfig::hbBasic));
+        config.PageBytes_ = 8192;
+        OALayout layout = ObjectAllocator::Layout(sizeof(Student), config);
+        cout << "Page allocation: " << layout.PageAllocSize_ << ", alignment: " << layout.PageAlignment_
+             << ", blocks fit: " << (layout.ObjectsPerPage_ && layout.PageSize_ <= layout.PageAllocSize_) << endl;
+
+        oa = new ObjectAllocator(sizeof(Student), config);
+        const void* first = oa->GetPageList();
+        for (unsigned i = 0; i <= layout.ObjectsPerPage_; i++) // one more than a page holds
+            oa->Allocate();
+        cout << "Pages in use: " << oa->GetStats().PagesInUse_ << ", page aligned: "
+             << (reinterpret_cast<size_t>(first) % layout.PageAlignment_ == 0 && reinterpret_cast<size_t>(oa->GetPageList()) % layout.PageAlignment_ == 0) << endl;
+        unsigned count = oa->ValidatePages(ValidateCallback);
+        cout << "Number of corruptions: " << count << endl;
+        delete oa;
+        oa = 0;
+
+        config.PageBytes_ = 16; // not even one block
+        oa = new ObjectAllocator(sizeof(Student), config);
+        cout << "****** Page too small not detected in TestPageBytes. ******" << endl;
+    }
+    catch (const OAException& e)
+    {
+        PrintException("constructor", e);
+    }
+    delete oa;
+}
+
+//****************************************************************************************************
+//****************************************************************************************************
+void TestAdaptivePages(void)
+{
+    ObjectAllocator* oa = 0;
+    void* blocks[200];
+    unsigned i;
+    try
+    {
+        OAConfig config(false, 4, 0, true, 2);
+        config.AdaptivePages_ = true;
+        config.MinObjectsPerPage_ = 4;
+        config.MaxObjectsPerPage_ = 64;
+        oa = new ObjectAllocator(sizeof(Student), config);
+
+        for (i = 0; i < 200; i++)
+            blocks[i] = oa->Allocate();
+        OAStats stats = oa->GetStats();
+        cout << "Pages grew: " << (stats.PageGrowths_ > 0) << ", fewer pages than at 4 per page: " << (stats.PagesInUse_ < 50)
+             << ", largest page within bounds: " << (oa->GetConfig().ObjectsPerPage_ <= 64) << endl;
+        unsigned count = oa->ValidatePages(ValidateCallback);
+        cout << "Number of corruptions: " << count << endl;
+
+        for (i = 0; i < 200; i++)
+            oa->Free(blocks[i]);
+        cout << "Pages freed: " << (oa->FreeEmptyPages() == stats.PagesInUse_) << endl;
+        PrintCounts(oa);
+    }
+    catch (const OAException& e)
+    {
+        if (SHOW_EXCEPTIONS)
+            cout << e.what() << endl;
+        else
+            cout << "Exception thrown in TestAdaptivePages." << endl;
+    }
+    delete oa;
+}
+
+void PrintCounts(const ObjectAllocator* nm)
+{
+    OAStats stats = nm->GetStats();
+    cout << "Pages in use: " << stats.PagesInUse_;
+    cout << ", Objects in use: " << stats.ObjectsInUse_;
+    cout << ", Available objects: " << stats.FreeObjects_;
+    cout << ", Allocs: " << stats.Allocations_;
+    cout << ", Frees: " << stats.Deallocations_ << endl;
+}
+
+void PrintCounts2(const ObjectAllocator* nm)
+{
+    OAStats stats = nm->GetStats();
+    cout << "Allocs: " << stats.Allocations_;
+    cout << ", Frees: " << stats.Deallocations_ << endl;
+}
+
+void PrintConfig(const ObjectAllocator* oa)
+{
+    cout << "Object size = " << oa->GetStats().ObjectSize_;
+    cout << ", Page size = " << oa->GetStats().PageSize_;
+    cout << ", Pad bytes = " << oa->GetConfig().PadBytes_;
+    cout << ", ObjectsPerPage = " << oa->GetConfig().ObjectsPerPage_;
+    cout << ", MaxPages = " << oa->GetConfig().MaxPages_;
+    cout << ", MaxObjects = " << oa->GetConfig().ObjectsPerPage_ * oa->GetConfig().MaxPages_;
+    cout << endl;
+    cout << "Alignment = " << oa->GetConfig().Alignment_;
+    cout << ", LeftAlign = " << oa->GetConfig().LeftAlignSize_;
+    cout << ", InterAlign = " << oa->GetConfig().InterAlignSize_;
+    cout << ", HeaderBlocks = ";
+    if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbNone)
+        cout << "None";
+    else if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbBasic)
+        cout << "Basic";
+    else if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbExtended)
+        cout << "Extended";
+    else if (oa->GetConfig().HBlockInfo_.type_ == OAConfig::hbExternal)
+        cout << "External";
+    cout << ", Header size = " << oa->GetConfig().HBlockInfo_.size_;
+    cout << endl;
+}
+
+void DumpPages(const ObjectAllocator* nm, unsigned width)
+{
+    const unsigned char* pages = static_cast<const unsigned char*>(nm->GetPageList());
+    const unsigned char* realpage = pages;
+
+    size_t header_size = nm->GetConfig().HBlockInfo_.size_;
+
+    while (pages)
+    {
+        unsigned count = 0;
+
+        if (SHOWREAL)
+            printf("%p\n", pages);
+        else
+            printf("XXXXXXXX\n");
+
+        // print column header
+        for (unsigned j = 0; j < width; j++)
+            printf(" %2i", j);
+        printf("\n");
+
+        // "Next page" pointer in the page
+        if (SHOWREAL)
+        {
+            for (unsigned i = 0; i < sizeof(void*); i++, count++)
+                printf(" %02X", *pages++);
+        }
+        else
+        {
+            for (unsigned j = 0; j < sizeof(void*); pages++, count++, j++)
+                printf(" %s", "XX");
+        }
+
+
+        // Left leading alignment bytes
+        if (nm->GetConfig().Alignment_ > 1)
+        {
+            // leading alignment block (if any)
+            for (unsigned j = 0; j < nm->GetConfig().LeftAlignSize_; count++, j++)
+            {
+                if (count >= width)
+                {
+                    printf("\n");
+                    count = 0;
+                }
+                printf(" %02X", *pages++);
+            }
+        }
+
+        // Dump each object and its associated info
+        for (unsigned int i = 0; i < nm->GetConfig().ObjectsPerPage_; i++)
+        {
+            // inter-block alignment (not on first block)
+            if (i > 0)
+            {
+                for (unsigned j = 0; j < nm->GetConfig().InterAlignSize_; count++, j++)
+                {
+                    if (count >= width)
+                    {
+                        printf("\n");
                         count = 0;
                     }
                     printf(" %02X", *pages++);
@@ -2215,6 +3261,101 @@ int main(int argc, char** argv)
         cout << endl;
         break;
 #endif
+    case 22:
+        cout << "============================== Test checksums..." << endl;
+        TestChecksums();
+        cout << endl;
+        break;
+    case 23:
+        cout << "============================== Test debug state on a live pool..." << endl;
+        TestDebugStateLive();
+        cout << endl;
+        break;
+    case 24:
+        cout << "============================== Test page cache..." << endl;
+        TestPageCache();
+        cout << endl;
+        break;
+    case 25:
+        cout << "============================== Test AllocateIov..." << endl;
+        TestAllocateIov();
+        cout << endl;
+        break;
+    case 26:
+        cout << "============================== Test labels..." << endl;
+        TestLabels();
+        cout << endl;
+        break;
+    case 27:
+        cout << "============================== Test lifetimes..." << endl;
+        TestLifetimes();
+        cout << endl;
+        break;
+    case 28:
+        cout << "============================== Test snapshots..." << endl;
+        TestSnapshots();
+        cout << endl;
+        break;
+    case 29:
+        cout << "============================== Test stale objects..." << endl;
+        TestStaleObjects();
+        cout << endl;
+        break;
+    case 30:
+        cout << "============================== Test bounded allocator..." << endl;
+        TestBounded();
+        cout << endl;
+        break;
+    case 31:
+        cout << "============================== Test striped allocator..." << endl;
+        TestStriped();
+        cout << endl;
+        break;
+    case 32:
+        cout << "============================== Test flat combining allocator..." << endl;
+        TestFlatCombining();
+        cout << endl;
+        break;
+    case 33:
+        cout << "============================== Test pool queue..." << endl;
+        TestPoolQueue();
+        cout << endl;
+        break;
+    case 34:
+        cout << "============================== Test spare pages..." << endl;
+        TestSparePages();
+        cout << endl;
+        break;
+    case 35:
+        cout << "============================== Test page reclaimer..." << endl;
+        TestReclaimer();
+        cout << endl;
+        break;
+    case 36:
+        cout << "============================== Test fork-friendly allocator..." << endl;
+        TestForkFriendly();
+        cout << endl;
+        break;
+    case 37:
+        cout << "============================== Test pool registry..." << endl;
+        TestPoolRegistry();
+        cout << endl;
+        break;
+    case 38:
+        cout << "============================== Test OOM handler..." << endl;
+        TestOOMHandler();
+        cout << endl;
+        break;
+    case 39:
+        cout << "============================== Test page bytes..." << endl;
+        TestPageBytes();
+        cout << endl;
+        break;
+    case 40:
+        cout << "============================== Test adaptive pages..." << endl;
+        TestAdaptivePages();
+        cout << endl;
+        break;
     default:
         cout << "============================== Students..." << endl;
         DoStudents(0, false);
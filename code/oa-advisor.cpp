@@ -0,0 +1,228 @@
+/**
+ * @file oa-advisor.cpp
+ * @author Matthias Ong Si En (ong.s@digipen.edu)
+ * @par Course: CSD2181
+ * @par Assignment #1
+ * @brief Command line tool that suggests ObjectsPerPage_ values for a pool. It uses the allocator's
+ * own layout math (ObjectAllocator::Layout) and ranks the candidates by how much of the OS pages
+ * spanned by each page holds client data.
+ * @date 2026-10-18
+ * @copyright Copyright (C) 2022 DigiPen Institute of Technology.
+ * Reproduction or disclosure of this file or its contents without the
+ * prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+
+#include "ObjectAllocator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const size_t DEFAULT_SYSTEM_OVERHEAD = 16; // bytes the system allocator adds to each page (glibc chunk header, rounded)
+static const unsigned DEFAULT_MAX_SPAN = 4;       // largest number of OS pages a candidate may span
+static const unsigned DEFAULT_LISTED = 10;        // number of candidates printed
+
+/*!
+  One ObjectsPerPage_ value and how well it uses memory
+*/
+struct Candidate
+{
+    unsigned objects_;  //!< ObjectsPerPage_
+    OALayout layout_;   //!< sizes the allocator would use
+    size_t osPage_;     //!< OS page size the candidate was fitted to
+    size_t spanned_;    //!< bytes of OS pages touched by one page (allocation rounded up)
+    double efficiency_; //!< client bytes / spanned bytes
+};
+
+/**
+ * @brief Prints how to use the tool
+ *
+ * @param program Name of the executable
+ */
+static void Usage(const char *program)
+{
+    printf("Usage: %s <object size> [options]\n", program);
+    printf("  -a N      alignment in bytes (default 0)\n");
+    printf("  -p N      pad bytes on each side of a block (default 0)\n");
+    printf("  -h TYPE   header blocks: none, basic, extended[:N], external (default none)\n");
+    printf("  -t        blocks carry the hidden tag (TrackLabels_, Lifetimes_ or Checksums_)\n");
+    printf("  -o N      OS page size to fit, may be repeated (default 4096 and 2097152)\n");
+    printf("  -m N      largest number of OS pages one page may span (default %u)\n", DEFAULT_MAX_SPAN);
+    printf("  -s N      bytes the system allocator adds to each page (default %u)\n", static_cast<unsigned>(DEFAULT_SYSTEM_OVERHEAD));
+    printf("  -k N      number of candidates listed (default %u)\n", DEFAULT_LISTED);
+}
+
+/**
+ * @brief Parses a header type
+ *
+ * @param text none, basic, extended[:N] or external
+ * @param info Parsed header
+ * @return true Valid
+ * @return false Unknown header type
+ */
+static bool ParseHeader(const char *text, OAConfig::HeaderBlockInfo &info)
+{
+    if (strcmp(text, "none") == 0)
+        info = OAConfig::HeaderBlockInfo(OAConfig::hbNone);
+    else if (strcmp(text, "basic") == 0)
+        info = OAConfig::HeaderBlockInfo(OAConfig::hbBasic);
+    else if (strncmp(text, "extended", 8) == 0)
+        info = OAConfig::HeaderBlockInfo(OAConfig::hbExtended, text[8] == ':' ? static_cast<unsigned>(atoi(text + 9)) : 0);
+    else if (strcmp(text, "external") == 0)
+        info = OAConfig::HeaderBlockInfo(OAConfig::hbExternal);
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @brief Rounds up to a multiple
+ *
+ * @param size Size to round
+ * @param multiple Multiple to round to
+ * @return size_t Rounded size
+ */
+static size_t RoundUp(size_t size, size_t multiple)
+{
+    return (size + multiple - 1) / multiple * multiple;
+}
+
+/**
+ * @brief Largest ObjectsPerPage_ whose page, with the system overhead, fits in limit bytes
+ *
+ * @param objectSize Size of the objects
+ * @param config Configuration (ObjectsPerPage_ is ignored)
+ * @param limit Bytes available
+ * @param overhead Bytes the system allocator adds
+ * @return unsigned Object count, 0 if not even one object fits
+ */
+static unsigned LargestFit(size_t objectSize, OAConfig config, size_t limit, size_t overhead)
+{
+    config.ObjectsPerPage_ = 1;
+    OALayout one = ObjectAllocator::Layout(objectSize, config);
+    if (one.PageAllocSize_ + overhead > limit)
+        return 0;
+    unsigned objects = static_cast<unsigned>((limit - overhead - one.PageAllocSize_) / one.BlockSize_) + 1;
+    for (;;) //confirm with the real layout
+    {
+        config.ObjectsPerPage_ = objects;
+        if (ObjectAllocator::Layout(objectSize, config).PageAllocSize_ + overhead <= limit || objects == 1)
+            return objects;
+        --objects;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || atoi(argv[1]) <= 0)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    size_t objectSize = static_cast<size_t>(atoi(argv[1]));
+    OAConfig config;
+    std::vector<size_t> osPages;
+    unsigned maxSpan = DEFAULT_MAX_SPAN;
+    size_t overhead = DEFAULT_SYSTEM_OVERHEAD;
+    unsigned listed = DEFAULT_LISTED;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const char *option = argv[i];
+        if (strcmp(option, "-t") == 0)
+        {
+            config.TrackLabels_ = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (strcmp(option, "-a") == 0)
+            config.Alignment_ = static_cast<unsigned>(atoi(value));
+        else if (strcmp(option, "-p") == 0)
+            config.PadBytes_ = static_cast<unsigned>(atoi(value));
+        else if (strcmp(option, "-h") == 0 && ParseHeader(value, config.HBlockInfo_))
+            continue;
+        else if (strcmp(option, "-o") == 0 && atol(value) > 0)
+            osPages.push_back(static_cast<size_t>(atol(value)));
+        else if (strcmp(option, "-m") == 0 && atoi(value) > 0)
+            maxSpan = static_cast<unsigned>(atoi(value));
+        else if (strcmp(option, "-s") == 0)
+            overhead = static_cast<size_t>(atoi(value));
+        else if (strcmp(option, "-k") == 0 && atoi(value) > 0)
+            listed = static_cast<unsigned>(atoi(value));
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (osPages.empty())
+    {
+        osPages.push_back(4096);
+        osPages.push_back(2 * 1024 * 1024);
+    }
+
+    //The best candidate for each OS page size and span is the largest page that still fits in it
+    std::vector<Candidate> candidates;
+    for (size_t osPage : osPages)
+    {
+        for (unsigned span = 1; span <= maxSpan; ++span)
+        {
+            unsigned objects = LargestFit(objectSize, config, osPage * span, overhead);
+            if (!objects)
+                continue;
+            config.ObjectsPerPage_ = objects;
+            Candidate candidate;
+            candidate.objects_ = objects;
+            candidate.layout_ = ObjectAllocator::Layout(objectSize, config);
+            candidate.osPage_ = osPage;
+            candidate.spanned_ = RoundUp(candidate.layout_.PageAllocSize_ + overhead, osPage);
+            candidate.efficiency_ = static_cast<double>(objectSize * objects) / static_cast<double>(candidate.spanned_);
+            candidates.push_back(candidate);
+        }
+    }
+    if (candidates.empty())
+    {
+        printf("No page of these OS page sizes can hold a single %u byte object.\n", static_cast<unsigned>(objectSize));
+        return 1;
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.efficiency_ > b.efficiency_ + 0.0001 || b.efficiency_ > a.efficiency_ + 0.0001)
+            return a.efficiency_ > b.efficiency_;
+        return a.spanned_ < b.spanned_; //about the same efficiency, prefer the smaller page
+    });
+
+    config.ObjectsPerPage_ = 1;
+    OALayout one = ObjectAllocator::Layout(objectSize, config);
+    printf("Object size = %u, Alignment = %u, Pad bytes = %u, Header size = %u, Page header = %u, Block size = %u\n",
+           static_cast<unsigned>(objectSize), config.Alignment_, config.PadBytes_, static_cast<unsigned>(config.HBlockInfo_.size_),
+           static_cast<unsigned>(one.PageHeader_), static_cast<unsigned>(one.BlockSize_));
+    printf("%10s %12s %12s %10s %8s %12s %11s\n", "Objects", "PageSize_", "Allocated", "OS page", "Pages", "Wasted tail", "Efficiency");
+    for (unsigned i = 0; i < candidates.size() && i < listed; ++i)
+    {
+        const Candidate &c = candidates[i];
+        size_t allocated = c.layout_.PageAllocSize_ + overhead;
+        printf("%10u %12u %12u %10u %8u %12u %10.2f%%\n", c.objects_, static_cast<unsigned>(c.layout_.PageSize_),
+               static_cast<unsigned>(allocated), static_cast<unsigned>(c.osPage_), static_cast<unsigned>(c.spanned_ / c.osPage_),
+               static_cast<unsigned>(c.spanned_ - allocated), c.efficiency_ * 100.0);
+    }
+
+    //What the allocator itself picks with OAConfig::PageBytes_ set to each OS page size
+    printf("\n%10s %12s %12s %11s\n", "PageBytes_", "Objects", "PageSize_", "Efficiency");
+    for (size_t osPage : osPages)
+    {
+        OAConfig exact = config;
+        exact.PageBytes_ = osPage;
+        OALayout layout = ObjectAllocator::Layout(objectSize, exact);
+        printf("%10u %12u %12u %10.2f%%\n", static_cast<unsigned>(osPage), layout.ObjectsPerPage_, static_cast<unsigned>(layout.PageSize_),
+               100.0 * static_cast<double>(objectSize * layout.ObjectsPerPage_) / static_cast<double>(osPage));
+    }
+    return 0;
+}